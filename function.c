@@ -639,6 +639,39 @@ mass_infer_function_return_type(
   return lazy_value->descriptor;
 }
 
+static inline bool
+mass_function_instance_matches(
+  const Value *instance_value,
+  const Function_Info *fn_info,
+  const Calling_Convention *calling_convention,
+  const Program *program
+) {
+  assert(instance_value->descriptor->tag == Descriptor_Tag_Function_Instance);
+  const Descriptor_Function_Instance *instance = &instance_value->descriptor->Function_Instance;
+  assert(instance->info);
+  assert(instance->program);
+  assert(instance->call_setup.calling_convention);
+  return (
+    instance->info == fn_info &&
+    instance->call_setup.calling_convention == calling_convention &&
+    instance->program == program
+  );
+}
+
+static inline void
+mass_function_literal_add_instance(
+  Mass_Context *context,
+  Function_Literal *literal,
+  u64 instance_hash,
+  Value *instance_value
+) {
+  dyn_array_push(literal->instances, instance_value);
+  if (!hash_map_has(literal->instance_map, instance_hash)) {
+    hash_map_set(literal->instance_map, instance_hash, dyn_array_length(literal->instances));
+  }
+  context->compilation->counters.function_instance_count += 1;
+}
+
 static Value *
 mass_function_literal_instance_for_info(
   Mass_Context *context,
@@ -654,19 +687,28 @@ mass_function_literal_instance_for_info(
       .allocator = context->allocator,
       .capacity = 4
     );
+    literal->instance_map =
+      hash_map_make(Function_Instance_Map, .allocator = context->allocator, .initial_capacity = 8);
+    dyn_array_push(context->compilation->instantiated_literals, literal);
   }
 
-  for (u64 i = 0; i < dyn_array_length(literal->instances); ++i) {
-    Value *instance_value = *dyn_array_get(literal->instances, i);
-    assert(instance_value->descriptor->tag == Descriptor_Tag_Function_Instance);
-    const Descriptor_Function_Instance *instance = &instance_value->descriptor->Function_Instance;
-    assert(instance->info);
-    assert(instance->program);
-    assert(instance->call_setup.calling_convention);
-    if (instance->info != fn_info) continue;
-    if (instance->call_setup.calling_convention != calling_convention) continue;
-    if (instance->program != program) continue;
-    return instance_value;
+  u64 instance_hash = hash_u64(
+    hash_pointer(fn_info) ^ hash_pointer(calling_convention) ^ ((u64)(uintptr_t)program << 1)
+  );
+  u64 *instance_index = hash_map_get(literal->instance_map, instance_hash);
+  if (instance_index) {
+    Value *instance_value = *dyn_array_get(literal->instances, *instance_index - 1);
+    if (mass_function_instance_matches(instance_value, fn_info, calling_convention, program)) {
+      return instance_value;
+    }
+    // Only the first instance with a given hash is in the map so on a collision
+    // the one we are looking for might be anywhere in the list
+    for (u64 i = 0; i < dyn_array_length(literal->instances); ++i) {
+      instance_value = *dyn_array_get(literal->instances, i);
+      if (mass_function_instance_matches(instance_value, fn_info, calling_convention, program)) {
+        return instance_value;
+      }
+    }
   }
 
   if (mass_has_error(context)) return 0;
@@ -682,7 +724,7 @@ mass_function_literal_instance_for_info(
       allocator_allocate(context->allocator, Value),
       instance_descriptor, storage, literal->body->source_range
     );
-    dyn_array_push(literal->instances, cached_instance);
+    mass_function_literal_add_instance(context, literal, instance_hash, cached_instance);
     return cached_instance;
   }
 
@@ -691,7 +733,7 @@ mass_function_literal_instance_for_info(
   Value *cached_instance = value_make(
     context, instance_descriptor, code_label32(call_label), literal->body->source_range
   );
-  dyn_array_push(literal->instances, cached_instance);
+  mass_function_literal_add_instance(context, literal, instance_hash, cached_instance);
 
   const Descriptor *return_descriptor = fn_info->return_descriptor;
   Scope *body_scope = scope_make_declarative(context->allocator, literal->own_scope);
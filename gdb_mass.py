@@ -59,11 +59,13 @@ class HashMapPrinter:
     def children(self):
         keys = {}
         entries = self.val['entries']
+        control = self.val['control']
         length = int(self.val['capacity'])
         hint = self.display_hint()
         for i in range(length):
-            entry = entries[i]
-            if bool(entry['occupied']) and not bool(entry['tombstone']):
+            # Occupied slots store a 7-bit hash tag, EMPTY and DELETED have the high bit set
+            if int(control[i]) < 0x80:
+                entry = entries[i]
                 key = entry['key'].dereference()
                 value = entry['value'].dereference()
                 if hint == 'array':
@@ -94,13 +94,6 @@ compiler_scope_define_exports(
     mass_ensure_symbol(compilation, slice_literal("Ast_Statement")),
     type_ast_statement_value
   );
-  Source_Range Ast_Block__source_range;
-  INIT_LITERAL_SOURCE_RANGE(&Ast_Block__source_range, "Ast_Block");
-  scope_define_value(
-    scope, VALUE_STATIC_EPOCH, Ast_Block__source_range,
-    mass_ensure_symbol(compilation, slice_literal("Ast_Block")),
-    type_ast_block_value
-  );
   Source_Range Group_Square__source_range;
   INIT_LITERAL_SOURCE_RANGE(&Group_Square__source_range, "Group_Square");
   scope_define_value(
@@ -1115,6 +1108,22 @@ compiler_scope_define_exports(
       .descriptor = &descriptor_value_view
     }
   );
+  MASS_DEFINE_FUNCTION(
+    Function_Info_Flags_None | Function_Info_Flags_Intrinsic,
+    mass_eval_uncached, "eval_uncached", &descriptor_value_pointer,
+    (Resolved_Function_Parameter) {
+      .symbol = mass_ensure_symbol(compilation, slice_literal("context")),
+      .descriptor = &descriptor_mass_context_pointer
+    },
+    (Resolved_Function_Parameter) {
+      .symbol = mass_ensure_symbol(compilation, slice_literal("parser")),
+      .descriptor = &descriptor_parser_pointer
+    },
+    (Resolved_Function_Parameter) {
+      .symbol = mass_ensure_symbol(compilation, slice_literal("args")),
+      .descriptor = &descriptor_value_view
+    }
+  );
   MASS_DEFINE_FUNCTION(
     Function_Info_Flags_None | Function_Info_Flags_Intrinsic,
     mass_inline_module, "inline_module", &descriptor_value_pointer,
@@ -1355,6 +1364,18 @@ compiler_scope_define_exports(
       .descriptor = &descriptor_descriptor_pointer
     }
   );
+  MASS_DEFINE_FUNCTION(
+    Function_Info_Flags_None,
+    descriptor_intern, "descriptor_intern", &descriptor_descriptor_pointer,
+    (Resolved_Function_Parameter) {
+      .symbol = mass_ensure_symbol(compilation, slice_literal("compilation")),
+      .descriptor = &descriptor_compilation_pointer
+    },
+    (Resolved_Function_Parameter) {
+      .symbol = mass_ensure_symbol(compilation, slice_literal("descriptor")),
+      .descriptor = &descriptor_descriptor_pointer
+    }
+  );
   MASS_DEFINE_FUNCTION(
     Function_Info_Flags_None,
     scope_make_imperative, "scope_make_imperative", &descriptor_scope_pointer,
@@ -10,9 +10,11 @@ MASS_TYPES = {
   'Parse_Error': 'struct',
   'Value_View': 'struct',
   'Symbol': 'struct',
+  'Interned_Symbol': 'struct',
   'Group_Paren': 'struct',
   'Ast_Return': 'struct',
   'Ast_Statement': 'struct',
+  'Token_Stream': 'struct',
   'Ast_Block': 'struct',
   'Group_Square': 'struct',
   'Ast_Using': 'struct',
@@ -49,9 +51,14 @@ MASS_TYPES = {
   'Operator_Flags': 'enum',
   'Operator': 'tagged_union',
   'Scope_Entry': 'struct',
+  'Imperative_Scope_Chunk': 'struct',
   'Operator_Map': 'hash_map',
   'Operator_Symbol_Map': 'hash_map',
+  'Declarative_Scope_Layout': 'enum',
   'Scope': 'tagged_union',
+  'Overload_First_Parameter': 'enum',
+  'Overload_Candidate': 'struct',
+  'Overload_Bucket': 'struct',
   'Overload': 'struct',
   'Undecidable_Match': 'struct',
   'Overload_Match': 'tagged_union',
@@ -70,6 +77,8 @@ MASS_TYPES = {
   'Function_Info': 'struct',
   'Function_Header_Flags': 'enum',
   'Function_Specialization': 'struct',
+  'Function_Instance_Map': 'hash_map',
+  'Function_Specialization_Map': 'hash_map',
   'Function_Header': 'struct',
   'Function_Literal': 'struct',
   'Function_Call_Parameter_Flags': 'enum',
@@ -94,6 +103,8 @@ MASS_TYPES = {
   'Calling_Convention': 'struct',
   'Mass_Trampoline': 'struct',
   'Struct_Field_Set': 'hash_map',
+  'Struct_Field_Name_Map': 'hash_map',
+  'Struct_Field_Index_Map': 'hash_map',
   'Slice_Set': 'hash_map',
   'Symbol_Map': 'hash_map',
   'Trampoline_Map': 'hash_map',
@@ -105,8 +116,17 @@ MASS_TYPES = {
   'Jit': 'struct',
   'Static_Pointer_Length_Map': 'hash_map',
   'Descriptor_Pointer_To_Cache_Map': 'hash_map',
+  'Descriptor_Intern_Entry': 'struct',
+  'Descriptor_Intern_Map': 'hash_map',
   'Intrinsic_Proc_Cache_Map': 'hash_map',
   'Common_Symbols': 'struct',
+  'Scope_Lookup_Cache_Entry': 'struct',
+  'Overload_Match_Cache_Entry': 'struct',
+  'Overload_Match_Cache_Map': 'hash_map',
+  'Compile_Time_Eval_Input': 'struct',
+  'Compile_Time_Eval_Cache_Entry': 'struct',
+  'Compile_Time_Eval_Cache_Map': 'hash_map',
+  'Compilation_Counters': 'struct',
   'Compilation': 'struct',
   'Instruction_Extension_Type': 'enum',
   'Operand_Encoding_Type': 'enum',
@@ -59,6 +59,10 @@ typedef struct Symbol Symbol;
 typedef dyn_array_type(Symbol *) Array_Symbol_Ptr;
 typedef dyn_array_type(const Symbol *) Array_Const_Symbol_Ptr;
 
+typedef struct Interned_Symbol Interned_Symbol;
+typedef dyn_array_type(Interned_Symbol *) Array_Interned_Symbol_Ptr;
+typedef dyn_array_type(const Interned_Symbol *) Array_Const_Interned_Symbol_Ptr;
+
 typedef struct Group_Paren Group_Paren;
 typedef dyn_array_type(Group_Paren *) Array_Group_Paren_Ptr;
 typedef dyn_array_type(const Group_Paren *) Array_Const_Group_Paren_Ptr;
@@ -71,6 +75,10 @@ typedef struct Ast_Statement Ast_Statement;
 typedef dyn_array_type(Ast_Statement *) Array_Ast_Statement_Ptr;
 typedef dyn_array_type(const Ast_Statement *) Array_Const_Ast_Statement_Ptr;
 
+typedef struct Token_Stream Token_Stream;
+typedef dyn_array_type(Token_Stream *) Array_Token_Stream_Ptr;
+typedef dyn_array_type(const Token_Stream *) Array_Const_Token_Stream_Ptr;
+
 typedef struct Ast_Block Ast_Block;
 typedef dyn_array_type(Ast_Block *) Array_Ast_Block_Ptr;
 typedef dyn_array_type(const Ast_Block *) Array_Const_Ast_Block_Ptr;
@@ -428,16 +436,64 @@ typedef struct Scope_Entry Scope_Entry;
 typedef dyn_array_type(Scope_Entry *) Array_Scope_Entry_Ptr;
 typedef dyn_array_type(const Scope_Entry *) Array_Const_Scope_Entry_Ptr;
 
+typedef struct Imperative_Scope_Chunk Imperative_Scope_Chunk;
+typedef dyn_array_type(Imperative_Scope_Chunk *) Array_Imperative_Scope_Chunk_Ptr;
+typedef dyn_array_type(const Imperative_Scope_Chunk *) Array_Const_Imperative_Scope_Chunk_Ptr;
+
 typedef struct Operator_Map Operator_Map;
 
 typedef struct Operator_Symbol_Map Operator_Symbol_Map;
 
+typedef enum Declarative_Scope_Layout {
+  Declarative_Scope_Layout_Flat = 0,
+  Declarative_Scope_Layout_Map = 1,
+  Declarative_Scope_Layout_Direct = 2,
+} Declarative_Scope_Layout;
+
+const char *declarative_scope_layout_name(Declarative_Scope_Layout value) {
+  if (value == 0) return "Declarative_Scope_Layout_Flat";
+  if (value == 1) return "Declarative_Scope_Layout_Map";
+  if (value == 2) return "Declarative_Scope_Layout_Direct";
+  assert(!"Unexpected value for enum Declarative_Scope_Layout");
+  return 0;
+};
+
+typedef dyn_array_type(Declarative_Scope_Layout *) Array_Declarative_Scope_Layout_Ptr;
+typedef dyn_array_type(const Declarative_Scope_Layout *) Array_Const_Declarative_Scope_Layout_Ptr;
+
 typedef struct Scope Scope;
 typedef struct Scope_Imperative Scope_Imperative;
 typedef struct Scope_Declarative Scope_Declarative;
 typedef dyn_array_type(Scope *) Array_Scope_Ptr;
 typedef dyn_array_type(const Scope *) Array_Const_Scope_Ptr;
 
+typedef enum Overload_First_Parameter {
+  Overload_First_Parameter_Any = 0,
+  Overload_First_Parameter_Runtime = 1,
+  Overload_First_Parameter_Exact_Static = 2,
+  Overload_First_Parameter_Generic_Static = 3,
+} Overload_First_Parameter;
+
+const char *overload_first_parameter_name(Overload_First_Parameter value) {
+  if (value == 0) return "Overload_First_Parameter_Any";
+  if (value == 1) return "Overload_First_Parameter_Runtime";
+  if (value == 2) return "Overload_First_Parameter_Exact_Static";
+  if (value == 3) return "Overload_First_Parameter_Generic_Static";
+  assert(!"Unexpected value for enum Overload_First_Parameter");
+  return 0;
+};
+
+typedef dyn_array_type(Overload_First_Parameter *) Array_Overload_First_Parameter_Ptr;
+typedef dyn_array_type(const Overload_First_Parameter *) Array_Const_Overload_First_Parameter_Ptr;
+
+typedef struct Overload_Candidate Overload_Candidate;
+typedef dyn_array_type(Overload_Candidate *) Array_Overload_Candidate_Ptr;
+typedef dyn_array_type(const Overload_Candidate *) Array_Const_Overload_Candidate_Ptr;
+
+typedef struct Overload_Bucket Overload_Bucket;
+typedef dyn_array_type(Overload_Bucket *) Array_Overload_Bucket_Ptr;
+typedef dyn_array_type(const Overload_Bucket *) Array_Const_Overload_Bucket_Ptr;
+
 typedef struct Overload Overload;
 typedef dyn_array_type(Overload *) Array_Overload_Ptr;
 typedef dyn_array_type(const Overload *) Array_Const_Overload_Ptr;
@@ -561,6 +617,10 @@ typedef struct Function_Specialization Function_Specialization;
 typedef dyn_array_type(Function_Specialization *) Array_Function_Specialization_Ptr;
 typedef dyn_array_type(const Function_Specialization *) Array_Const_Function_Specialization_Ptr;
 
+typedef struct Function_Instance_Map Function_Instance_Map;
+
+typedef struct Function_Specialization_Map Function_Specialization_Map;
+
 typedef struct Function_Header Function_Header;
 typedef dyn_array_type(Function_Header *) Array_Function_Header_Ptr;
 typedef dyn_array_type(const Function_Header *) Array_Const_Function_Header_Ptr;
@@ -737,6 +797,10 @@ typedef dyn_array_type(const Mass_Trampoline *) Array_Const_Mass_Trampoline_Ptr;
 
 typedef struct Struct_Field_Set Struct_Field_Set;
 
+typedef struct Struct_Field_Name_Map Struct_Field_Name_Map;
+
+typedef struct Struct_Field_Index_Map Struct_Field_Index_Map;
+
 typedef struct Slice_Set Slice_Set;
 
 typedef struct Symbol_Map Symbol_Map;
@@ -763,12 +827,45 @@ typedef struct Static_Pointer_Length_Map Static_Pointer_Length_Map;
 
 typedef struct Descriptor_Pointer_To_Cache_Map Descriptor_Pointer_To_Cache_Map;
 
+typedef struct Descriptor_Intern_Entry Descriptor_Intern_Entry;
+typedef dyn_array_type(Descriptor_Intern_Entry *) Array_Descriptor_Intern_Entry_Ptr;
+typedef dyn_array_type(const Descriptor_Intern_Entry *) Array_Const_Descriptor_Intern_Entry_Ptr;
+
+typedef struct Descriptor_Intern_Map Descriptor_Intern_Map;
+
 typedef struct Intrinsic_Proc_Cache_Map Intrinsic_Proc_Cache_Map;
 
 typedef struct Common_Symbols Common_Symbols;
 typedef dyn_array_type(Common_Symbols *) Array_Common_Symbols_Ptr;
 typedef dyn_array_type(const Common_Symbols *) Array_Const_Common_Symbols_Ptr;
 
+typedef dyn_array_type(File_Mapping *) Array_File_Mapping_Ptr;
+typedef dyn_array_type(const File_Mapping *) Array_Const_File_Mapping_Ptr;
+
+typedef struct Scope_Lookup_Cache_Entry Scope_Lookup_Cache_Entry;
+typedef dyn_array_type(Scope_Lookup_Cache_Entry *) Array_Scope_Lookup_Cache_Entry_Ptr;
+typedef dyn_array_type(const Scope_Lookup_Cache_Entry *) Array_Const_Scope_Lookup_Cache_Entry_Ptr;
+
+typedef struct Overload_Match_Cache_Entry Overload_Match_Cache_Entry;
+typedef dyn_array_type(Overload_Match_Cache_Entry *) Array_Overload_Match_Cache_Entry_Ptr;
+typedef dyn_array_type(const Overload_Match_Cache_Entry *) Array_Const_Overload_Match_Cache_Entry_Ptr;
+
+typedef struct Overload_Match_Cache_Map Overload_Match_Cache_Map;
+
+typedef struct Compile_Time_Eval_Input Compile_Time_Eval_Input;
+typedef dyn_array_type(Compile_Time_Eval_Input *) Array_Compile_Time_Eval_Input_Ptr;
+typedef dyn_array_type(const Compile_Time_Eval_Input *) Array_Const_Compile_Time_Eval_Input_Ptr;
+
+typedef struct Compile_Time_Eval_Cache_Entry Compile_Time_Eval_Cache_Entry;
+typedef dyn_array_type(Compile_Time_Eval_Cache_Entry *) Array_Compile_Time_Eval_Cache_Entry_Ptr;
+typedef dyn_array_type(const Compile_Time_Eval_Cache_Entry *) Array_Const_Compile_Time_Eval_Cache_Entry_Ptr;
+
+typedef struct Compile_Time_Eval_Cache_Map Compile_Time_Eval_Cache_Map;
+
+typedef struct Compilation_Counters Compilation_Counters;
+typedef dyn_array_type(Compilation_Counters *) Array_Compilation_Counters_Ptr;
+typedef dyn_array_type(const Compilation_Counters *) Array_Const_Compilation_Counters_Ptr;
+
 typedef struct Compilation Compilation;
 typedef dyn_array_type(Compilation *) Array_Compilation_Ptr;
 typedef dyn_array_type(const Compilation *) Array_Const_Compilation_Ptr;
@@ -907,6 +1004,9 @@ static Value * mass_pointer_to_type
 static Value * mass_eval
   (Mass_Context * context, Parser * parser, Value_View args);
 
+static Value * mass_eval_uncached
+  (Mass_Context * context, Parser * parser, Value_View args);
+
 static Value * mass_inline_module
   (Mass_Context * context, Parser * parser, Value_View args);
 
@@ -964,6 +1064,9 @@ static Value * mass_tuple_get
 static const Descriptor * descriptor_pointer_to
   (Compilation * compilation, const Descriptor * descriptor);
 
+static const Descriptor * descriptor_intern
+  (Compilation * compilation, const Descriptor * descriptor);
+
 static Scope * scope_make_imperative
   (const Allocator * allocator, const Scope * parent, const Scope_Entry * entry);
 
@@ -1242,6 +1345,8 @@ typedef dyn_array_type(Source_Position) Array_Source_Position;
 typedef struct Source_File {
   Slice path;
   Slice text;
+  u32 * line_starts;
+  u64 line_count;
 } Source_File;
 typedef dyn_array_type(Source_File) Array_Source_File;
 
@@ -1319,6 +1424,14 @@ typedef struct Symbol {
 } Symbol;
 typedef dyn_array_type(Symbol) Array_Symbol;
 
+typedef struct Interned_Symbol {
+  Symbol symbol;
+  u32 id;
+  u32 definition_count;
+  u32 operator_fixities;
+} Interned_Symbol;
+typedef dyn_array_type(Interned_Symbol) Array_Interned_Symbol;
+
 typedef struct Group_Paren {
   Value_View children;
 } Group_Paren;
@@ -1335,9 +1448,23 @@ typedef struct Ast_Statement {
 } Ast_Statement;
 typedef dyn_array_type(Ast_Statement) Array_Ast_Statement;
 
+typedef struct Token_Stream {
+  const Source_File * file;
+  u8 * tags;
+  u32 * offsets;
+  u32 * lengths;
+  u64 * payloads;
+  u32 count;
+  u32 _count_padding;
+} Token_Stream;
+typedef dyn_array_type(Token_Stream) Array_Token_Stream;
+
 typedef struct Ast_Block {
   Ast_Statement * first_statement;
   Ast_Statement * last_statement;
+  const Token_Stream * lazy_stream;
+  u32 lazy_from_token;
+  u32 lazy_to_token;
 } Ast_Block;
 typedef dyn_array_type(Ast_Block) Array_Ast_Block;
 
@@ -1356,6 +1483,7 @@ typedef struct Section {
   Slice name;
   u32 base_rva;
   Section_Permissions permissions;
+  s64 execution_offset;
 } Section;
 typedef dyn_array_type(Section) Array_Section;
 
@@ -1742,6 +1870,7 @@ operator_as_intrinsic(const Operator *operator) {
 typedef dyn_array_type(Operator) Array_Operator;
 typedef struct Scope_Entry {
   Value * value;
+  const Symbol * symbol;
   Slice name;
   Epoch epoch;
   const Value * latest_forced_value;
@@ -1749,6 +1878,17 @@ typedef struct Scope_Entry {
 } Scope_Entry;
 typedef dyn_array_type(Scope_Entry) Array_Scope_Entry;
 
+typedef struct Imperative_Scope_Chunk {
+  u32 count;
+  u32 capacity;
+  u32 index_mask;
+  u32 _index_mask_padding;
+  Scope_Entry * entries;
+  u16 * shadowed;
+  u16 * index;
+} Imperative_Scope_Chunk;
+typedef dyn_array_type(Imperative_Scope_Chunk) Array_Imperative_Scope_Chunk;
+
 hash_map_template(Operator_Map, const Symbol *, Operator *, hash_pointer, const_void_pointer_equal)
 hash_map_template(Operator_Symbol_Map, const Symbol *, const Symbol *, hash_pointer, const_void_pointer_equal)
 typedef enum {
@@ -1762,9 +1902,17 @@ const char *scope_tag_name(Scope_Tag value) {
   return "<unknown value>";}
 
 typedef struct Scope_Imperative {
-  Scope_Entry entry;
+  Imperative_Scope_Chunk * chunk;
+  u32 count;
+  u32 _count_padding;
 } Scope_Imperative;
 typedef struct Scope_Declarative {
+  Declarative_Scope_Layout layout;
+  u32 count;
+  u32 capacity;
+  u32 _capacity_padding;
+  Scope_Entry * * entries;
+  u32 * flat_ids;
   Scope_Map * map;
 } Scope_Declarative;
 typedef struct Scope {
@@ -1788,9 +1936,24 @@ scope_as_declarative(const Scope *scope) {
   return &scope->Declarative;
 }
 typedef dyn_array_type(Scope) Array_Scope;
-typedef struct Overload {
+typedef struct Overload_Candidate {
   Value * value;
-  Value * next;
+  Overload_First_Parameter first_parameter;
+  u32 requires_compile_time_arguments;
+  u64 first_parameter_kind;
+} Overload_Candidate;
+typedef dyn_array_type(Overload_Candidate) Array_Overload_Candidate;
+
+typedef struct Overload_Bucket {
+  u32 from;
+  u32 to;
+} Overload_Bucket;
+typedef dyn_array_type(Overload_Bucket) Array_Overload_Bucket;
+
+typedef struct Overload {
+  Array_Value_Ptr values;
+  Array_Overload_Candidate candidates;
+  Array_Overload_Bucket buckets;
 } Overload;
 typedef dyn_array_type(Overload) Array_Overload;
 
@@ -2084,9 +2247,12 @@ typedef dyn_array_type(Function_Info) Array_Function_Info;
 typedef struct Function_Specialization {
   Array_Function_Parameter parameters;
   Function_Info * info;
+  u64 previous_with_same_hash;
 } Function_Specialization;
 typedef dyn_array_type(Function_Specialization) Array_Function_Specialization;
 
+hash_map_template(Function_Instance_Map, u64, u64, hash_u64, u64_equal)
+hash_map_template(Function_Specialization_Map, u64, u64, hash_u64, u64_equal)
 typedef struct Function_Header {
   Function_Header_Flags flags;
   u32 generic_parameter_count;
@@ -2102,6 +2268,8 @@ typedef struct Function_Literal {
   u64 * overload_lock_count;
   Array_Value_Ptr instances;
   Array_Function_Specialization specializations;
+  Function_Specialization_Map * specialization_map;
+  Function_Instance_Map * instance_map;
 } Function_Literal;
 typedef dyn_array_type(Function_Literal) Array_Function_Literal;
 
@@ -2533,10 +2701,13 @@ typedef struct Mass_Trampoline {
   const Descriptor * args_descriptor;
   const Function_Info * original_info;
   Mass_Trampoline_Proc proc;
+  const void * direct_proc;
 } Mass_Trampoline;
 typedef dyn_array_type(Mass_Trampoline) Array_Mass_Trampoline;
 
 hash_map_template(Struct_Field_Set, const Struct_Field *, u64, hash_pointer, const_void_pointer_equal)
+hash_map_slice_template(Struct_Field_Name_Map, u64)
+hash_map_template(Struct_Field_Index_Map, const Descriptor *, Struct_Field_Name_Map *, hash_pointer, const_void_pointer_equal)
 hash_map_slice_template(Slice_Set, u64)
 hash_map_slice_template(Symbol_Map, Symbol *)
 hash_map_template(Trampoline_Map, const Function_Info *, const Mass_Trampoline *, hash_pointer, const_void_pointer_equal)
@@ -2558,11 +2729,21 @@ typedef struct Jit {
   Jit_Import_Library_Handle_Map * import_library_handles;
   Jit_Counters previous_counts;
   void * platform_specific_payload;
+  Virtual_Memory_Buffer thunk_buffer;
+  Allocator * thunk_allocator;
+  u64 thunk_buffer_floor;
 } Jit;
 typedef dyn_array_type(Jit) Array_Jit;
 
 hash_map_template(Static_Pointer_Length_Map, const void *, u64, hash_pointer, const_void_pointer_equal)
 hash_map_template(Descriptor_Pointer_To_Cache_Map, const Descriptor *, const Descriptor *, hash_pointer, const_void_pointer_equal)
+typedef struct Descriptor_Intern_Entry {
+  const Descriptor * descriptor;
+  Descriptor_Intern_Entry * next;
+} Descriptor_Intern_Entry;
+typedef dyn_array_type(Descriptor_Intern_Entry) Array_Descriptor_Intern_Entry;
+
+hash_map_template(Descriptor_Intern_Map, u64, Descriptor_Intern_Entry *, hash_u64, u64_equal)
 hash_map_template(Intrinsic_Proc_Cache_Map, const Value *, Mass_Intrinsic_Proc, hash_pointer, const_void_pointer_equal)
 typedef struct Common_Symbols {
   const Symbol * apply;
@@ -2593,6 +2774,63 @@ typedef struct Common_Symbols {
 } Common_Symbols;
 typedef dyn_array_type(Common_Symbols) Array_Common_Symbols;
 
+typedef dyn_array_type(File_Mapping) Array_File_Mapping;
+
+typedef struct Scope_Lookup_Cache_Entry {
+  const Scope * scope;
+  const Symbol * symbol;
+  Scope_Entry * entry;
+  u64 definition_count;
+} Scope_Lookup_Cache_Entry;
+typedef dyn_array_type(Scope_Lookup_Cache_Entry) Array_Scope_Lookup_Cache_Entry;
+
+typedef struct Overload_Match_Cache_Entry {
+  const Value * overload_set;
+  const Program * program;
+  Array_Resolved_Function_Parameter arguments;
+  Overload_Match match;
+  Overload_Match_Cache_Entry * next;
+} Overload_Match_Cache_Entry;
+typedef dyn_array_type(Overload_Match_Cache_Entry) Array_Overload_Match_Cache_Entry;
+
+hash_map_template(Overload_Match_Cache_Map, u64, Overload_Match_Cache_Entry *, hash_u64, u64_equal)
+typedef struct Compile_Time_Eval_Input {
+  const Symbol * symbol;
+  const Descriptor * descriptor;
+  u64 bits;
+} Compile_Time_Eval_Input;
+typedef dyn_array_type(Compile_Time_Eval_Input) Array_Compile_Time_Eval_Input;
+
+typedef struct Compile_Time_Eval_Cache_Entry {
+  Source_Range source_range;
+  Array_Compile_Time_Eval_Input inputs;
+  const Value * result;
+  Compile_Time_Eval_Cache_Entry * next;
+} Compile_Time_Eval_Cache_Entry;
+typedef dyn_array_type(Compile_Time_Eval_Cache_Entry) Array_Compile_Time_Eval_Cache_Entry;
+
+hash_map_template(Compile_Time_Eval_Cache_Map, u64, Compile_Time_Eval_Cache_Entry *, hash_u64, u64_equal)
+typedef struct Compilation_Counters {
+  u64 scope_lookup_cache_hits;
+  u64 scope_lookup_cache_misses;
+  u64 overload_match_cache_hits;
+  u64 overload_match_cache_misses;
+  u64 function_instance_count;
+  u64 descriptor_intern_hits;
+  u64 descriptor_intern_misses;
+  u64 compile_time_eval_cache_hits;
+  u64 compile_time_eval_cache_misses;
+  u64 compile_time_eval_interpreted_count;
+  u64 compile_time_eval_jit_count;
+  u64 trampoline_direct_call_count;
+  u64 trampoline_struct_call_count;
+  u64 jit_commit_count;
+  u64 jit_skipped_commit_count;
+  u64 jit_reclaimed_thunk_count;
+  u64 jit_reclaimed_thunk_byte_count;
+} Compilation_Counters;
+typedef dyn_array_type(Compilation_Counters) Array_Compilation_Counters;
+
 typedef struct Compilation {
   Virtual_Memory_Buffer temp_buffer;
   Allocator * temp_allocator;
@@ -2606,10 +2844,20 @@ typedef struct Compilation {
   Scope * root_scope;
   Program * runtime_program;
   Mass_Result * result;
+  Array_File_Mapping source_file_mappings;
   Symbol_Map * symbol_cache_map;
+  u64 symbol_count;
+  Scope_Lookup_Cache_Entry * scope_lookup_cache;
+  Compilation_Counters counters;
+  Overload_Match_Cache_Map * overload_match_cache_map;
+  Compile_Time_Eval_Cache_Map * compile_time_eval_cache_map;
+  u64 overload_lock_depth;
+  Array_Function_Literal_Ptr instantiated_literals;
   Operator_Symbol_Map * prefix_operator_symbol_map;
   Operator_Symbol_Map * infix_or_suffix_operator_symbol_map;
   Descriptor_Pointer_To_Cache_Map * descriptor_pointer_to_cache_map;
+  Descriptor_Intern_Map * descriptor_intern_map;
+  Struct_Field_Index_Map * struct_field_index_map;
   Intrinsic_Proc_Cache_Map * intrinsic_proc_cache_map;
   Common_Symbols common_symbols;
   Operator apply_operator;
@@ -2724,6 +2972,11 @@ static Descriptor descriptor_array_symbol;
 static Descriptor descriptor_array_symbol_ptr;
 static Descriptor descriptor_symbol_pointer;
 static Descriptor descriptor_symbol_pointer_pointer;
+static Descriptor descriptor_interned_symbol;
+static Descriptor descriptor_array_interned_symbol;
+static Descriptor descriptor_array_interned_symbol_ptr;
+static Descriptor descriptor_interned_symbol_pointer;
+static Descriptor descriptor_interned_symbol_pointer_pointer;
 static Descriptor descriptor_group_paren;
 static Descriptor descriptor_array_group_paren;
 static Descriptor descriptor_array_group_paren_ptr;
@@ -2739,6 +2992,11 @@ static Descriptor descriptor_array_ast_statement;
 static Descriptor descriptor_array_ast_statement_ptr;
 static Descriptor descriptor_ast_statement_pointer;
 static Descriptor descriptor_ast_statement_pointer_pointer;
+static Descriptor descriptor_token_stream;
+static Descriptor descriptor_array_token_stream;
+static Descriptor descriptor_array_token_stream_ptr;
+static Descriptor descriptor_token_stream_pointer;
+static Descriptor descriptor_token_stream_pointer_pointer;
 static Descriptor descriptor_ast_block;
 static Descriptor descriptor_array_ast_block;
 static Descriptor descriptor_array_ast_block_ptr;
@@ -2933,14 +3191,41 @@ static Descriptor descriptor_array_scope_entry;
 static Descriptor descriptor_array_scope_entry_ptr;
 static Descriptor descriptor_scope_entry_pointer;
 static Descriptor descriptor_scope_entry_pointer_pointer;
+static Descriptor descriptor_imperative_scope_chunk;
+static Descriptor descriptor_array_imperative_scope_chunk;
+static Descriptor descriptor_array_imperative_scope_chunk_ptr;
+static Descriptor descriptor_imperative_scope_chunk_pointer;
+static Descriptor descriptor_imperative_scope_chunk_pointer_pointer;
 MASS_DEFINE_OPAQUE_C_TYPE(operator_map, Operator_Map);
 MASS_DEFINE_OPAQUE_C_TYPE(operator_symbol_map, Operator_Symbol_Map);
+static Descriptor descriptor_declarative_scope_layout;
+static Descriptor descriptor_array_declarative_scope_layout;
+static Descriptor descriptor_array_declarative_scope_layout_ptr;
+static Descriptor descriptor_array_const_declarative_scope_layout_ptr;
+static Descriptor descriptor_declarative_scope_layout_pointer;
+static Descriptor descriptor_declarative_scope_layout_pointer_pointer;
 static Descriptor descriptor_scope;
 static Descriptor descriptor_array_scope;
 static Descriptor descriptor_array_scope_ptr;
 static Descriptor descriptor_array_const_scope_ptr;
 static Descriptor descriptor_scope_pointer;
 static Descriptor descriptor_scope_pointer_pointer;
+static Descriptor descriptor_overload_first_parameter;
+static Descriptor descriptor_array_overload_first_parameter;
+static Descriptor descriptor_array_overload_first_parameter_ptr;
+static Descriptor descriptor_array_const_overload_first_parameter_ptr;
+static Descriptor descriptor_overload_first_parameter_pointer;
+static Descriptor descriptor_overload_first_parameter_pointer_pointer;
+static Descriptor descriptor_overload_candidate;
+static Descriptor descriptor_array_overload_candidate;
+static Descriptor descriptor_array_overload_candidate_ptr;
+static Descriptor descriptor_overload_candidate_pointer;
+static Descriptor descriptor_overload_candidate_pointer_pointer;
+static Descriptor descriptor_overload_bucket;
+static Descriptor descriptor_array_overload_bucket;
+static Descriptor descriptor_array_overload_bucket_ptr;
+static Descriptor descriptor_overload_bucket_pointer;
+static Descriptor descriptor_overload_bucket_pointer_pointer;
 static Descriptor descriptor_overload;
 static Descriptor descriptor_array_overload;
 static Descriptor descriptor_array_overload_ptr;
@@ -3041,6 +3326,8 @@ static Descriptor descriptor_array_function_specialization;
 static Descriptor descriptor_array_function_specialization_ptr;
 static Descriptor descriptor_function_specialization_pointer;
 static Descriptor descriptor_function_specialization_pointer_pointer;
+MASS_DEFINE_OPAQUE_C_TYPE(function_instance_map, Function_Instance_Map);
+MASS_DEFINE_OPAQUE_C_TYPE(function_specialization_map, Function_Specialization_Map);
 static Descriptor descriptor_function_header;
 static Descriptor descriptor_array_function_header;
 static Descriptor descriptor_array_function_header_ptr;
@@ -3167,6 +3454,8 @@ static Descriptor descriptor_array_mass_trampoline_ptr;
 static Descriptor descriptor_mass_trampoline_pointer;
 static Descriptor descriptor_mass_trampoline_pointer_pointer;
 MASS_DEFINE_OPAQUE_C_TYPE(struct_field_set, Struct_Field_Set);
+MASS_DEFINE_OPAQUE_C_TYPE(struct_field_name_map, Struct_Field_Name_Map);
+MASS_DEFINE_OPAQUE_C_TYPE(struct_field_index_map, Struct_Field_Index_Map);
 MASS_DEFINE_OPAQUE_C_TYPE(slice_set, Slice_Set);
 MASS_DEFINE_OPAQUE_C_TYPE(symbol_map, Symbol_Map);
 MASS_DEFINE_OPAQUE_C_TYPE(trampoline_map, Trampoline_Map);
@@ -3186,12 +3475,51 @@ static Descriptor descriptor_jit_pointer;
 static Descriptor descriptor_jit_pointer_pointer;
 MASS_DEFINE_OPAQUE_C_TYPE(static_pointer_length_map, Static_Pointer_Length_Map);
 MASS_DEFINE_OPAQUE_C_TYPE(descriptor_pointer_to_cache_map, Descriptor_Pointer_To_Cache_Map);
+static Descriptor descriptor_descriptor_intern_entry;
+static Descriptor descriptor_array_descriptor_intern_entry;
+static Descriptor descriptor_array_descriptor_intern_entry_ptr;
+static Descriptor descriptor_descriptor_intern_entry_pointer;
+static Descriptor descriptor_descriptor_intern_entry_pointer_pointer;
+MASS_DEFINE_OPAQUE_C_TYPE(descriptor_intern_map, Descriptor_Intern_Map);
 MASS_DEFINE_OPAQUE_C_TYPE(intrinsic_proc_cache_map, Intrinsic_Proc_Cache_Map);
 static Descriptor descriptor_common_symbols;
 static Descriptor descriptor_array_common_symbols;
 static Descriptor descriptor_array_common_symbols_ptr;
 static Descriptor descriptor_common_symbols_pointer;
 static Descriptor descriptor_common_symbols_pointer_pointer;
+static Descriptor descriptor_file_mapping;
+static Descriptor descriptor_array_file_mapping;
+static Descriptor descriptor_array_file_mapping_ptr;
+static Descriptor descriptor_array_const_file_mapping_ptr;
+static Descriptor descriptor_file_mapping_pointer;
+static Descriptor descriptor_file_mapping_pointer_pointer;
+static Descriptor descriptor_scope_lookup_cache_entry;
+static Descriptor descriptor_array_scope_lookup_cache_entry;
+static Descriptor descriptor_array_scope_lookup_cache_entry_ptr;
+static Descriptor descriptor_scope_lookup_cache_entry_pointer;
+static Descriptor descriptor_scope_lookup_cache_entry_pointer_pointer;
+static Descriptor descriptor_overload_match_cache_entry;
+static Descriptor descriptor_array_overload_match_cache_entry;
+static Descriptor descriptor_array_overload_match_cache_entry_ptr;
+static Descriptor descriptor_overload_match_cache_entry_pointer;
+static Descriptor descriptor_overload_match_cache_entry_pointer_pointer;
+MASS_DEFINE_OPAQUE_C_TYPE(overload_match_cache_map, Overload_Match_Cache_Map);
+static Descriptor descriptor_compile_time_eval_input;
+static Descriptor descriptor_array_compile_time_eval_input;
+static Descriptor descriptor_array_compile_time_eval_input_ptr;
+static Descriptor descriptor_compile_time_eval_input_pointer;
+static Descriptor descriptor_compile_time_eval_input_pointer_pointer;
+static Descriptor descriptor_compile_time_eval_cache_entry;
+static Descriptor descriptor_array_compile_time_eval_cache_entry;
+static Descriptor descriptor_array_compile_time_eval_cache_entry_ptr;
+static Descriptor descriptor_compile_time_eval_cache_entry_pointer;
+static Descriptor descriptor_compile_time_eval_cache_entry_pointer_pointer;
+MASS_DEFINE_OPAQUE_C_TYPE(compile_time_eval_cache_map, Compile_Time_Eval_Cache_Map);
+static Descriptor descriptor_compilation_counters;
+static Descriptor descriptor_array_compilation_counters;
+static Descriptor descriptor_array_compilation_counters_ptr;
+static Descriptor descriptor_compilation_counters_pointer;
+static Descriptor descriptor_compilation_counters_pointer_pointer;
 static Descriptor descriptor_compilation;
 static Descriptor descriptor_array_compilation;
 static Descriptor descriptor_array_compilation_ptr;
@@ -3250,6 +3578,7 @@ static Descriptor descriptor_mass_typed_symbol;
 static Descriptor descriptor_mass_pointer_to;
 static Descriptor descriptor_mass_pointer_to_type;
 static Descriptor descriptor_mass_eval;
+static Descriptor descriptor_mass_eval_uncached;
 static Descriptor descriptor_mass_inline_module;
 static Descriptor descriptor_mass_c_struct;
 static Descriptor descriptor_mass_exports;
@@ -3269,6 +3598,7 @@ static Descriptor descriptor_mass_constraint_function_instance_type;
 static Descriptor descriptor_mass_tuple_length;
 static Descriptor descriptor_mass_tuple_get;
 static Descriptor descriptor_descriptor_pointer_to;
+static Descriptor descriptor_descriptor_intern;
 static Descriptor descriptor_scope_make_imperative;
 static Descriptor descriptor_scope_make_declarative;
 static Descriptor descriptor_mass_ensure_symbol;
@@ -3549,6 +3879,16 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(source_file, Source_File,
     .name = slice_literal_fields("text"),
     .offset = offsetof(Source_File, text),
   },
+  {
+    .descriptor = &descriptor_i32_pointer,
+    .name = slice_literal_fields("line_starts"),
+    .offset = offsetof(Source_File, line_starts),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("line_count"),
+    .offset = offsetof(Source_File, line_count),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(source_file);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_source_file_ptr, source_file_pointer, Array_Source_File_Ptr);
@@ -3734,6 +4074,33 @@ MASS_DEFINE_C_DYN_ARRAY_TYPE(array_symbol_ptr, symbol_pointer, Array_Symbol_Ptr)
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_symbol, symbol, Array_Symbol);
 DEFINE_VALUE_IS_AS_HELPERS(Symbol, symbol);
 DEFINE_VALUE_IS_AS_HELPERS(Symbol *, symbol_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(interned_symbol, Interned_Symbol,
+  {
+    .descriptor = &descriptor_symbol,
+    .name = slice_literal_fields("symbol"),
+    .offset = offsetof(Interned_Symbol, symbol),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("id"),
+    .offset = offsetof(Interned_Symbol, id),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("definition_count"),
+    .offset = offsetof(Interned_Symbol, definition_count),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("operator_fixities"),
+    .offset = offsetof(Interned_Symbol, operator_fixities),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(interned_symbol);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_interned_symbol_ptr, interned_symbol_pointer, Array_Interned_Symbol_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_interned_symbol, interned_symbol, Array_Interned_Symbol);
+DEFINE_VALUE_IS_AS_HELPERS(Interned_Symbol, interned_symbol);
+DEFINE_VALUE_IS_AS_HELPERS(Interned_Symbol *, interned_symbol_pointer);
 MASS_DEFINE_STRUCT_DESCRIPTOR(group_paren, Group_Paren,
   {
     .descriptor = &descriptor_value_view,
@@ -3775,6 +4142,43 @@ MASS_DEFINE_C_DYN_ARRAY_TYPE(array_ast_statement_ptr, ast_statement_pointer, Arr
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_ast_statement, ast_statement, Array_Ast_Statement);
 DEFINE_VALUE_IS_AS_HELPERS(Ast_Statement, ast_statement);
 DEFINE_VALUE_IS_AS_HELPERS(Ast_Statement *, ast_statement_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(token_stream, Token_Stream,
+  {
+    .descriptor = &descriptor_source_file_pointer,
+    .name = slice_literal_fields("file"),
+    .offset = offsetof(Token_Stream, file),
+  },
+  {
+    .descriptor = &descriptor_i8_pointer,
+    .name = slice_literal_fields("tags"),
+    .offset = offsetof(Token_Stream, tags),
+  },
+  {
+    .descriptor = &descriptor_i32_pointer,
+    .name = slice_literal_fields("offsets"),
+    .offset = offsetof(Token_Stream, offsets),
+  },
+  {
+    .descriptor = &descriptor_i32_pointer,
+    .name = slice_literal_fields("lengths"),
+    .offset = offsetof(Token_Stream, lengths),
+  },
+  {
+    .descriptor = &descriptor_i64_pointer,
+    .name = slice_literal_fields("payloads"),
+    .offset = offsetof(Token_Stream, payloads),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("count"),
+    .offset = offsetof(Token_Stream, count),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(token_stream);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_token_stream_ptr, token_stream_pointer, Array_Token_Stream_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_token_stream, token_stream, Array_Token_Stream);
+DEFINE_VALUE_IS_AS_HELPERS(Token_Stream, token_stream);
+DEFINE_VALUE_IS_AS_HELPERS(Token_Stream *, token_stream_pointer);
 MASS_DEFINE_STRUCT_DESCRIPTOR(ast_block, Ast_Block,
   {
     .descriptor = &descriptor_ast_statement_pointer,
@@ -3786,6 +4190,21 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(ast_block, Ast_Block,
     .name = slice_literal_fields("last_statement"),
     .offset = offsetof(Ast_Block, last_statement),
   },
+  {
+    .descriptor = &descriptor_token_stream_pointer,
+    .name = slice_literal_fields("lazy_stream"),
+    .offset = offsetof(Ast_Block, lazy_stream),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("lazy_from_token"),
+    .offset = offsetof(Ast_Block, lazy_from_token),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("lazy_to_token"),
+    .offset = offsetof(Ast_Block, lazy_to_token),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(ast_block);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_ast_block_ptr, ast_block_pointer, Array_Ast_Block_Ptr);
@@ -3845,6 +4264,11 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(section, Section,
     .name = slice_literal_fields("permissions"),
     .offset = offsetof(Section, permissions),
   },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("execution_offset"),
+    .offset = offsetof(Section, execution_offset),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(section);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_section_ptr, section_pointer, Array_Section_Ptr);
@@ -4737,6 +5161,11 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(scope_entry, Scope_Entry,
     .name = slice_literal_fields("value"),
     .offset = offsetof(Scope_Entry, value),
   },
+  {
+    .descriptor = &descriptor_symbol_pointer,
+    .name = slice_literal_fields("symbol"),
+    .offset = offsetof(Scope_Entry, symbol),
+  },
   {
     .descriptor = &descriptor_slice,
     .name = slice_literal_fields("name"),
@@ -4763,6 +5192,51 @@ MASS_DEFINE_C_DYN_ARRAY_TYPE(array_scope_entry_ptr, scope_entry_pointer, Array_S
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_scope_entry, scope_entry, Array_Scope_Entry);
 DEFINE_VALUE_IS_AS_HELPERS(Scope_Entry, scope_entry);
 DEFINE_VALUE_IS_AS_HELPERS(Scope_Entry *, scope_entry_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(imperative_scope_chunk, Imperative_Scope_Chunk,
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("count"),
+    .offset = offsetof(Imperative_Scope_Chunk, count),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("capacity"),
+    .offset = offsetof(Imperative_Scope_Chunk, capacity),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("index_mask"),
+    .offset = offsetof(Imperative_Scope_Chunk, index_mask),
+  },
+  {
+    .descriptor = &descriptor_scope_entry_pointer,
+    .name = slice_literal_fields("entries"),
+    .offset = offsetof(Imperative_Scope_Chunk, entries),
+  },
+  {
+    .descriptor = &descriptor_i16_pointer,
+    .name = slice_literal_fields("shadowed"),
+    .offset = offsetof(Imperative_Scope_Chunk, shadowed),
+  },
+  {
+    .descriptor = &descriptor_i16_pointer,
+    .name = slice_literal_fields("index"),
+    .offset = offsetof(Imperative_Scope_Chunk, index),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(imperative_scope_chunk);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_imperative_scope_chunk_ptr, imperative_scope_chunk_pointer, Array_Imperative_Scope_Chunk_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_imperative_scope_chunk, imperative_scope_chunk, Array_Imperative_Scope_Chunk);
+DEFINE_VALUE_IS_AS_HELPERS(Imperative_Scope_Chunk, imperative_scope_chunk);
+DEFINE_VALUE_IS_AS_HELPERS(Imperative_Scope_Chunk *, imperative_scope_chunk_pointer);
+MASS_DEFINE_OPAQUE_C_TYPE(declarative_scope_layout, Declarative_Scope_Layout)
+static C_Enum_Item declarative_scope_layout_items[] = {
+{ .name = slice_literal_fields("Flat"), .value = 0 },
+{ .name = slice_literal_fields("Map"), .value = 1 },
+{ .name = slice_literal_fields("Direct"), .value = 2 },
+};
+DEFINE_VALUE_IS_AS_HELPERS(Declarative_Scope_Layout, declarative_scope_layout);
+DEFINE_VALUE_IS_AS_HELPERS(Declarative_Scope_Layout *, declarative_scope_layout_pointer);
 /*union struct start */
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_scope_ptr, scope_pointer, Array_Scope_Ptr);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_scope, scope, Array_Scope);
@@ -4773,13 +5247,43 @@ static C_Enum_Item scope_tag_items[] = {
 };
 MASS_DEFINE_STRUCT_DESCRIPTOR(scope_imperative, Scope_Imperative,
   {
-    .descriptor = &descriptor_scope_entry,
-    .name = slice_literal_fields("entry"),
-    .offset = offsetof(Scope_Imperative, entry),
+    .descriptor = &descriptor_imperative_scope_chunk_pointer,
+    .name = slice_literal_fields("chunk"),
+    .offset = offsetof(Scope_Imperative, chunk),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("count"),
+    .offset = offsetof(Scope_Imperative, count),
   },
 );
 MASS_DEFINE_TYPE_VALUE(scope_imperative);
 MASS_DEFINE_STRUCT_DESCRIPTOR(scope_declarative, Scope_Declarative,
+  {
+    .descriptor = &descriptor_declarative_scope_layout,
+    .name = slice_literal_fields("layout"),
+    .offset = offsetof(Scope_Declarative, layout),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("count"),
+    .offset = offsetof(Scope_Declarative, count),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("capacity"),
+    .offset = offsetof(Scope_Declarative, capacity),
+  },
+  {
+    .descriptor = &descriptor_scope_entry_pointer_pointer,
+    .name = slice_literal_fields("entries"),
+    .offset = offsetof(Scope_Declarative, entries),
+  },
+  {
+    .descriptor = &descriptor_i32_pointer,
+    .name = slice_literal_fields("flat_ids"),
+    .offset = offsetof(Scope_Declarative, flat_ids),
+  },
   {
     .descriptor = &descriptor_scope_map_pointer,
     .name = slice_literal_fields("map"),
@@ -4818,16 +5322,74 @@ MASS_DEFINE_TYPE_VALUE(scope);
 DEFINE_VALUE_IS_AS_HELPERS(Scope, scope);
 DEFINE_VALUE_IS_AS_HELPERS(Scope *, scope_pointer);
 /*union struct end*/
-MASS_DEFINE_STRUCT_DESCRIPTOR(overload, Overload,
+MASS_DEFINE_OPAQUE_C_TYPE(overload_first_parameter, Overload_First_Parameter)
+static C_Enum_Item overload_first_parameter_items[] = {
+{ .name = slice_literal_fields("Any"), .value = 0 },
+{ .name = slice_literal_fields("Runtime"), .value = 1 },
+{ .name = slice_literal_fields("Exact_Static"), .value = 2 },
+{ .name = slice_literal_fields("Generic_Static"), .value = 3 },
+};
+DEFINE_VALUE_IS_AS_HELPERS(Overload_First_Parameter, overload_first_parameter);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_First_Parameter *, overload_first_parameter_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(overload_candidate, Overload_Candidate,
   {
     .descriptor = &descriptor_value_pointer,
     .name = slice_literal_fields("value"),
-    .offset = offsetof(Overload, value),
+    .offset = offsetof(Overload_Candidate, value),
   },
   {
-    .descriptor = &descriptor_value_pointer,
-    .name = slice_literal_fields("next"),
-    .offset = offsetof(Overload, next),
+    .descriptor = &descriptor_overload_first_parameter,
+    .name = slice_literal_fields("first_parameter"),
+    .offset = offsetof(Overload_Candidate, first_parameter),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("requires_compile_time_arguments"),
+    .offset = offsetof(Overload_Candidate, requires_compile_time_arguments),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("first_parameter_kind"),
+    .offset = offsetof(Overload_Candidate, first_parameter_kind),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(overload_candidate);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_overload_candidate_ptr, overload_candidate_pointer, Array_Overload_Candidate_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_overload_candidate, overload_candidate, Array_Overload_Candidate);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_Candidate, overload_candidate);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_Candidate *, overload_candidate_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(overload_bucket, Overload_Bucket,
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("from"),
+    .offset = offsetof(Overload_Bucket, from),
+  },
+  {
+    .descriptor = &descriptor_i32,
+    .name = slice_literal_fields("to"),
+    .offset = offsetof(Overload_Bucket, to),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(overload_bucket);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_overload_bucket_ptr, overload_bucket_pointer, Array_Overload_Bucket_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_overload_bucket, overload_bucket, Array_Overload_Bucket);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_Bucket, overload_bucket);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_Bucket *, overload_bucket_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(overload, Overload,
+  {
+    .descriptor = &descriptor_array_value_ptr,
+    .name = slice_literal_fields("values"),
+    .offset = offsetof(Overload, values),
+  },
+  {
+    .descriptor = &descriptor_array_overload_candidate,
+    .name = slice_literal_fields("candidates"),
+    .offset = offsetof(Overload, candidates),
+  },
+  {
+    .descriptor = &descriptor_array_overload_bucket,
+    .name = slice_literal_fields("buckets"),
+    .offset = offsetof(Overload, buckets),
   },
 );
 MASS_DEFINE_TYPE_VALUE(overload);
@@ -5463,6 +6025,11 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(function_specialization, Function_Specialization,
     .name = slice_literal_fields("info"),
     .offset = offsetof(Function_Specialization, info),
   },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("previous_with_same_hash"),
+    .offset = offsetof(Function_Specialization, previous_with_same_hash),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(function_specialization);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_function_specialization_ptr, function_specialization_pointer, Array_Function_Specialization_Ptr);
@@ -5527,6 +6094,16 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(function_literal, Function_Literal,
     .name = slice_literal_fields("specializations"),
     .offset = offsetof(Function_Literal, specializations),
   },
+  {
+    .descriptor = &descriptor_function_specialization_map_pointer,
+    .name = slice_literal_fields("specialization_map"),
+    .offset = offsetof(Function_Literal, specialization_map),
+  },
+  {
+    .descriptor = &descriptor_function_instance_map_pointer,
+    .name = slice_literal_fields("instance_map"),
+    .offset = offsetof(Function_Literal, instance_map),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(function_literal);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_function_literal_ptr, function_literal_pointer, Array_Function_Literal_Ptr);
@@ -6490,6 +7067,11 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(mass_trampoline, Mass_Trampoline,
     .name = slice_literal_fields("proc"),
     .offset = offsetof(Mass_Trampoline, proc),
   },
+  {
+    .descriptor = &descriptor_void_pointer,
+    .name = slice_literal_fields("direct_proc"),
+    .offset = offsetof(Mass_Trampoline, direct_proc),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(mass_trampoline);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_mass_trampoline_ptr, mass_trampoline_pointer, Array_Mass_Trampoline_Ptr);
@@ -6549,12 +7131,44 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(jit, Jit,
     .name = slice_literal_fields("platform_specific_payload"),
     .offset = offsetof(Jit, platform_specific_payload),
   },
+  {
+    .descriptor = &descriptor_virtual_memory_buffer,
+    .name = slice_literal_fields("thunk_buffer"),
+    .offset = offsetof(Jit, thunk_buffer),
+  },
+  {
+    .descriptor = &descriptor_allocator_pointer,
+    .name = slice_literal_fields("thunk_allocator"),
+    .offset = offsetof(Jit, thunk_allocator),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("thunk_buffer_floor"),
+    .offset = offsetof(Jit, thunk_buffer_floor),
+  },
 );
 MASS_DEFINE_TYPE_VALUE(jit);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_jit_ptr, jit_pointer, Array_Jit_Ptr);
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_jit, jit, Array_Jit);
 DEFINE_VALUE_IS_AS_HELPERS(Jit, jit);
 DEFINE_VALUE_IS_AS_HELPERS(Jit *, jit_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(descriptor_intern_entry, Descriptor_Intern_Entry,
+  {
+    .descriptor = &descriptor_descriptor_pointer,
+    .name = slice_literal_fields("descriptor"),
+    .offset = offsetof(Descriptor_Intern_Entry, descriptor),
+  },
+  {
+    .descriptor = &descriptor_descriptor_intern_entry_pointer,
+    .name = slice_literal_fields("next"),
+    .offset = offsetof(Descriptor_Intern_Entry, next),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(descriptor_intern_entry);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_descriptor_intern_entry_ptr, descriptor_intern_entry_pointer, Array_Descriptor_Intern_Entry_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_descriptor_intern_entry, descriptor_intern_entry, Array_Descriptor_Intern_Entry);
+DEFINE_VALUE_IS_AS_HELPERS(Descriptor_Intern_Entry, descriptor_intern_entry);
+DEFINE_VALUE_IS_AS_HELPERS(Descriptor_Intern_Entry *, descriptor_intern_entry_pointer);
 MASS_DEFINE_STRUCT_DESCRIPTOR(common_symbols, Common_Symbols,
   {
     .descriptor = &descriptor_symbol_pointer,
@@ -6687,6 +7301,211 @@ MASS_DEFINE_C_DYN_ARRAY_TYPE(array_common_symbols_ptr, common_symbols_pointer, A
 MASS_DEFINE_C_DYN_ARRAY_TYPE(array_common_symbols, common_symbols, Array_Common_Symbols);
 DEFINE_VALUE_IS_AS_HELPERS(Common_Symbols, common_symbols);
 DEFINE_VALUE_IS_AS_HELPERS(Common_Symbols *, common_symbols_pointer);
+MASS_DEFINE_OPAQUE_C_TYPE(file_mapping, File_Mapping)
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_file_mapping_ptr, file_mapping_pointer, Array_File_Mapping_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_file_mapping, file_mapping, Array_File_Mapping);
+DEFINE_VALUE_IS_AS_HELPERS(File_Mapping, file_mapping);
+DEFINE_VALUE_IS_AS_HELPERS(File_Mapping *, file_mapping_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(scope_lookup_cache_entry, Scope_Lookup_Cache_Entry,
+  {
+    .descriptor = &descriptor_scope_pointer,
+    .name = slice_literal_fields("scope"),
+    .offset = offsetof(Scope_Lookup_Cache_Entry, scope),
+  },
+  {
+    .descriptor = &descriptor_symbol_pointer,
+    .name = slice_literal_fields("symbol"),
+    .offset = offsetof(Scope_Lookup_Cache_Entry, symbol),
+  },
+  {
+    .descriptor = &descriptor_scope_entry_pointer,
+    .name = slice_literal_fields("entry"),
+    .offset = offsetof(Scope_Lookup_Cache_Entry, entry),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("definition_count"),
+    .offset = offsetof(Scope_Lookup_Cache_Entry, definition_count),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(scope_lookup_cache_entry);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_scope_lookup_cache_entry_ptr, scope_lookup_cache_entry_pointer, Array_Scope_Lookup_Cache_Entry_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_scope_lookup_cache_entry, scope_lookup_cache_entry, Array_Scope_Lookup_Cache_Entry);
+DEFINE_VALUE_IS_AS_HELPERS(Scope_Lookup_Cache_Entry, scope_lookup_cache_entry);
+DEFINE_VALUE_IS_AS_HELPERS(Scope_Lookup_Cache_Entry *, scope_lookup_cache_entry_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(overload_match_cache_entry, Overload_Match_Cache_Entry,
+  {
+    .descriptor = &descriptor_value_pointer,
+    .name = slice_literal_fields("overload_set"),
+    .offset = offsetof(Overload_Match_Cache_Entry, overload_set),
+  },
+  {
+    .descriptor = &descriptor_program_pointer,
+    .name = slice_literal_fields("program"),
+    .offset = offsetof(Overload_Match_Cache_Entry, program),
+  },
+  {
+    .descriptor = &descriptor_array_resolved_function_parameter,
+    .name = slice_literal_fields("arguments"),
+    .offset = offsetof(Overload_Match_Cache_Entry, arguments),
+  },
+  {
+    .descriptor = &descriptor_overload_match,
+    .name = slice_literal_fields("match"),
+    .offset = offsetof(Overload_Match_Cache_Entry, match),
+  },
+  {
+    .descriptor = &descriptor_overload_match_cache_entry_pointer,
+    .name = slice_literal_fields("next"),
+    .offset = offsetof(Overload_Match_Cache_Entry, next),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(overload_match_cache_entry);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_overload_match_cache_entry_ptr, overload_match_cache_entry_pointer, Array_Overload_Match_Cache_Entry_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_overload_match_cache_entry, overload_match_cache_entry, Array_Overload_Match_Cache_Entry);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_Match_Cache_Entry, overload_match_cache_entry);
+DEFINE_VALUE_IS_AS_HELPERS(Overload_Match_Cache_Entry *, overload_match_cache_entry_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(compile_time_eval_input, Compile_Time_Eval_Input,
+  {
+    .descriptor = &descriptor_symbol_pointer,
+    .name = slice_literal_fields("symbol"),
+    .offset = offsetof(Compile_Time_Eval_Input, symbol),
+  },
+  {
+    .descriptor = &descriptor_descriptor_pointer,
+    .name = slice_literal_fields("descriptor"),
+    .offset = offsetof(Compile_Time_Eval_Input, descriptor),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("bits"),
+    .offset = offsetof(Compile_Time_Eval_Input, bits),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(compile_time_eval_input);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_compile_time_eval_input_ptr, compile_time_eval_input_pointer, Array_Compile_Time_Eval_Input_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_compile_time_eval_input, compile_time_eval_input, Array_Compile_Time_Eval_Input);
+DEFINE_VALUE_IS_AS_HELPERS(Compile_Time_Eval_Input, compile_time_eval_input);
+DEFINE_VALUE_IS_AS_HELPERS(Compile_Time_Eval_Input *, compile_time_eval_input_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(compile_time_eval_cache_entry, Compile_Time_Eval_Cache_Entry,
+  {
+    .descriptor = &descriptor_source_range,
+    .name = slice_literal_fields("source_range"),
+    .offset = offsetof(Compile_Time_Eval_Cache_Entry, source_range),
+  },
+  {
+    .descriptor = &descriptor_array_compile_time_eval_input,
+    .name = slice_literal_fields("inputs"),
+    .offset = offsetof(Compile_Time_Eval_Cache_Entry, inputs),
+  },
+  {
+    .descriptor = &descriptor_value_pointer,
+    .name = slice_literal_fields("result"),
+    .offset = offsetof(Compile_Time_Eval_Cache_Entry, result),
+  },
+  {
+    .descriptor = &descriptor_compile_time_eval_cache_entry_pointer,
+    .name = slice_literal_fields("next"),
+    .offset = offsetof(Compile_Time_Eval_Cache_Entry, next),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(compile_time_eval_cache_entry);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_compile_time_eval_cache_entry_ptr, compile_time_eval_cache_entry_pointer, Array_Compile_Time_Eval_Cache_Entry_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_compile_time_eval_cache_entry, compile_time_eval_cache_entry, Array_Compile_Time_Eval_Cache_Entry);
+DEFINE_VALUE_IS_AS_HELPERS(Compile_Time_Eval_Cache_Entry, compile_time_eval_cache_entry);
+DEFINE_VALUE_IS_AS_HELPERS(Compile_Time_Eval_Cache_Entry *, compile_time_eval_cache_entry_pointer);
+MASS_DEFINE_STRUCT_DESCRIPTOR(compilation_counters, Compilation_Counters,
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("scope_lookup_cache_hits"),
+    .offset = offsetof(Compilation_Counters, scope_lookup_cache_hits),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("scope_lookup_cache_misses"),
+    .offset = offsetof(Compilation_Counters, scope_lookup_cache_misses),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("overload_match_cache_hits"),
+    .offset = offsetof(Compilation_Counters, overload_match_cache_hits),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("overload_match_cache_misses"),
+    .offset = offsetof(Compilation_Counters, overload_match_cache_misses),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("function_instance_count"),
+    .offset = offsetof(Compilation_Counters, function_instance_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("descriptor_intern_hits"),
+    .offset = offsetof(Compilation_Counters, descriptor_intern_hits),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("descriptor_intern_misses"),
+    .offset = offsetof(Compilation_Counters, descriptor_intern_misses),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("compile_time_eval_cache_hits"),
+    .offset = offsetof(Compilation_Counters, compile_time_eval_cache_hits),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("compile_time_eval_cache_misses"),
+    .offset = offsetof(Compilation_Counters, compile_time_eval_cache_misses),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("compile_time_eval_interpreted_count"),
+    .offset = offsetof(Compilation_Counters, compile_time_eval_interpreted_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("compile_time_eval_jit_count"),
+    .offset = offsetof(Compilation_Counters, compile_time_eval_jit_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("trampoline_direct_call_count"),
+    .offset = offsetof(Compilation_Counters, trampoline_direct_call_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("trampoline_struct_call_count"),
+    .offset = offsetof(Compilation_Counters, trampoline_struct_call_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("jit_commit_count"),
+    .offset = offsetof(Compilation_Counters, jit_commit_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("jit_skipped_commit_count"),
+    .offset = offsetof(Compilation_Counters, jit_skipped_commit_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("jit_reclaimed_thunk_count"),
+    .offset = offsetof(Compilation_Counters, jit_reclaimed_thunk_count),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("jit_reclaimed_thunk_byte_count"),
+    .offset = offsetof(Compilation_Counters, jit_reclaimed_thunk_byte_count),
+  },
+);
+MASS_DEFINE_TYPE_VALUE(compilation_counters);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_compilation_counters_ptr, compilation_counters_pointer, Array_Compilation_Counters_Ptr);
+MASS_DEFINE_C_DYN_ARRAY_TYPE(array_compilation_counters, compilation_counters, Array_Compilation_Counters);
+DEFINE_VALUE_IS_AS_HELPERS(Compilation_Counters, compilation_counters);
+DEFINE_VALUE_IS_AS_HELPERS(Compilation_Counters *, compilation_counters_pointer);
 MASS_DEFINE_STRUCT_DESCRIPTOR(compilation, Compilation,
   {
     .descriptor = &descriptor_virtual_memory_buffer,
@@ -6748,11 +7567,51 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(compilation, Compilation,
     .name = slice_literal_fields("result"),
     .offset = offsetof(Compilation, result),
   },
+  {
+    .descriptor = &descriptor_array_file_mapping,
+    .name = slice_literal_fields("source_file_mappings"),
+    .offset = offsetof(Compilation, source_file_mappings),
+  },
   {
     .descriptor = &descriptor_symbol_map_pointer,
     .name = slice_literal_fields("symbol_cache_map"),
     .offset = offsetof(Compilation, symbol_cache_map),
   },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("symbol_count"),
+    .offset = offsetof(Compilation, symbol_count),
+  },
+  {
+    .descriptor = &descriptor_scope_lookup_cache_entry_pointer,
+    .name = slice_literal_fields("scope_lookup_cache"),
+    .offset = offsetof(Compilation, scope_lookup_cache),
+  },
+  {
+    .descriptor = &descriptor_compilation_counters,
+    .name = slice_literal_fields("counters"),
+    .offset = offsetof(Compilation, counters),
+  },
+  {
+    .descriptor = &descriptor_overload_match_cache_map_pointer,
+    .name = slice_literal_fields("overload_match_cache_map"),
+    .offset = offsetof(Compilation, overload_match_cache_map),
+  },
+  {
+    .descriptor = &descriptor_compile_time_eval_cache_map_pointer,
+    .name = slice_literal_fields("compile_time_eval_cache_map"),
+    .offset = offsetof(Compilation, compile_time_eval_cache_map),
+  },
+  {
+    .descriptor = &descriptor_i64,
+    .name = slice_literal_fields("overload_lock_depth"),
+    .offset = offsetof(Compilation, overload_lock_depth),
+  },
+  {
+    .descriptor = &descriptor_array_function_literal_ptr,
+    .name = slice_literal_fields("instantiated_literals"),
+    .offset = offsetof(Compilation, instantiated_literals),
+  },
   {
     .descriptor = &descriptor_operator_symbol_map_pointer,
     .name = slice_literal_fields("prefix_operator_symbol_map"),
@@ -6768,6 +7627,16 @@ MASS_DEFINE_STRUCT_DESCRIPTOR(compilation, Compilation,
     .name = slice_literal_fields("descriptor_pointer_to_cache_map"),
     .offset = offsetof(Compilation, descriptor_pointer_to_cache_map),
   },
+  {
+    .descriptor = &descriptor_descriptor_intern_map_pointer,
+    .name = slice_literal_fields("descriptor_intern_map"),
+    .offset = offsetof(Compilation, descriptor_intern_map),
+  },
+  {
+    .descriptor = &descriptor_struct_field_index_map_pointer,
+    .name = slice_literal_fields("struct_field_index_map"),
+    .offset = offsetof(Compilation, struct_field_index_map),
+  },
   {
     .descriptor = &descriptor_intrinsic_proc_cache_map_pointer,
     .name = slice_literal_fields("intrinsic_proc_cache_map"),
@@ -0,0 +1,172 @@
+#include "prelude.h"
+
+// Compares `hash_bytes` against the previous chunked hash_u64-based implementation
+// on the identifiers and operators that appear in real Mass sources.
+//
+// Usage: hash_benchmark [file.mass...]
+// Needs to be run from the repository root when no files are provided.
+
+static const char *hash_benchmark_default_paths[] = {
+  "std/io.mass",
+  "std/linux.mass",
+  "std/meta.mass",
+  "std/prelude.mass",
+  "std/process.mass",
+  "std/virtual_memory.mass",
+  "std/win32.mass",
+  "std/x86_64.mass",
+  "fixtures/debugger.mass",
+  "fixtures/error_runtime_divide_by_zero.mass",
+  "fixtures/fizz_buzz.mass",
+  "fixtures/hello_world.mass",
+  "fixtures/relocations.mass",
+  "fixtures/sample_module.mass",
+  "fixtures/script_mode.mass",
+};
+
+static u64
+hash_bytes_previous(
+  const void *address,
+  u64 size
+) {
+  u64 result = hash_u64(size);
+  if (!size) return result;
+  const u8 *chunk_address = address;
+  const u8 *end_address = chunk_address + size;
+  for (; chunk_address + 8 < end_address; chunk_address += 8) {
+    u64 chunk;
+    memcpy(&chunk, chunk_address, 8);
+    result ^= hash_u64(chunk);
+  }
+  if (chunk_address != end_address) {
+    u64 chunk = 0;
+    memcpy(&chunk, chunk_address, end_address - chunk_address);
+    result ^= hash_u64(chunk);
+  }
+  return result;
+}
+
+static bool
+hash_benchmark_is_identifier_char(
+  char ch
+) {
+  return isalnum((u8)ch) || ch == '_';
+}
+
+static bool
+hash_benchmark_is_operator_char(
+  char ch
+) {
+  return !!strchr("+-*/%=<>!&|^~.:@", ch);
+}
+
+// Collects the same kind of runs that the tokenizer turns into symbols
+static void
+hash_benchmark_collect_symbols(
+  Slice text,
+  Array_Slice *symbols
+) {
+  for (u64 i = 0; i < text.length;) {
+    char ch = text.bytes[i];
+    if (ch == '/' && i + 1 < text.length && text.bytes[i + 1] == '/') {
+      while (i < text.length && text.bytes[i] != '\n') i++;
+      continue;
+    }
+    if (ch == '"') {
+      for (i += 1; i < text.length && text.bytes[i] != '"'; ++i);
+      i += 1;
+      continue;
+    }
+    bool (*predicate)(char) = 0;
+    if (hash_benchmark_is_identifier_char(ch) && !isdigit((u8)ch)) {
+      predicate = hash_benchmark_is_identifier_char;
+    } else if (hash_benchmark_is_operator_char(ch)) {
+      predicate = hash_benchmark_is_operator_char;
+    } else {
+      i += 1;
+      continue;
+    }
+    u64 start = i;
+    while (i < text.length && predicate(text.bytes[i])) i++;
+    dyn_array_push(*symbols, slice_sub(text, start, i));
+  }
+}
+
+typedef u64 (*Hash_Benchmark_Fn)(const void *, u64);
+
+static void
+hash_benchmark_run(
+  const char *name,
+  Hash_Benchmark_Fn hash_fn,
+  Array_Slice symbols,
+  u64 total_bytes,
+  u64 repeat_count
+) {
+  // Warm up caches and branch predictors before measuring
+  u64 checksum = 0;
+  DYN_ARRAY_FOREACH(Slice, it, symbols) checksum ^= hash_fn(it->bytes, it->length);
+
+  Performance_Counter counter = system_performance_counter_start();
+  for (u64 repeat = 0; repeat < repeat_count; ++repeat) {
+    DYN_ARRAY_FOREACH(Slice, it, symbols) checksum += hash_fn(it->bytes, it->length);
+  }
+  u64 elapsed_microseconds = system_performance_counter_end(&counter);
+  if (!elapsed_microseconds) elapsed_microseconds = 1;
+
+  u64 hash_count = dyn_array_length(symbols) * repeat_count;
+  double nanoseconds_per_hash = (double)elapsed_microseconds * 1000.0 / (double)hash_count;
+  double megabytes_per_second = (double)(total_bytes * repeat_count) / (double)elapsed_microseconds;
+  printf(
+    "%-10s %8.2f ns/hash %10.1f MB/s (checksum %016" PRIx64 ")\n",
+    name, nanoseconds_per_hash, megabytes_per_second, checksum
+  );
+}
+
+int
+main(
+  s32 argc,
+  char **argv
+) {
+  const char **paths = hash_benchmark_default_paths;
+  u64 path_count = countof(hash_benchmark_default_paths);
+  if (argc > 1) {
+    paths = (const char **)(argv + 1);
+    path_count = argc - 1;
+  }
+
+  Array_Slice symbols = dyn_array_make(Array_Slice, .capacity = 4096);
+  for (u64 i = 0; i < path_count; ++i) {
+    Fixed_Buffer *buffer = fixed_buffer_from_file(slice_from_c_string(paths[i]));
+    if (!buffer) {
+      fprintf(stderr, "Could not read %s\n", paths[i]);
+      return 1;
+    }
+    // Buffers are intentionally kept alive as symbols point into them
+    hash_benchmark_collect_symbols(fixed_buffer_as_slice(buffer), &symbols);
+  }
+
+  u64 total_bytes = 0;
+  u64 short_count = 0;
+  DYN_ARRAY_FOREACH(Slice, it, symbols) {
+    total_bytes += it->length;
+    if (it->length <= 16) short_count += 1;
+  }
+  u64 symbol_count = dyn_array_length(symbols);
+  if (!symbol_count) {
+    fprintf(stderr, "No symbols found\n");
+    return 1;
+  }
+  printf(
+    "%" PRIu64 " symbols, average length %.2f, %.1f%% are 16 bytes or shorter\n",
+    symbol_count, (double)total_bytes / (double)symbol_count,
+    100.0 * (double)short_count / (double)symbol_count
+  );
+
+  // Aim for roughly 50 million hashes per implementation
+  u64 repeat_count = 50000000 / symbol_count + 1;
+  hash_benchmark_run("previous", hash_bytes_previous, symbols, total_bytes, repeat_count);
+  hash_benchmark_run("current", hash_bytes, symbols, total_bytes, repeat_count);
+
+  dyn_array_destroy(symbols);
+  return 0;
+}
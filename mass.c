@@ -22,6 +22,9 @@ mass_cli_print_usage() {
     "  mass [flags] source_code.mass\n\n"
     "Flags:\n"
     "  --run              Run code in JIT mode\n"
+    "  --stats            Print compiler statistics after a successful run\n"
+    "  --huge-pages       Back compiler memory with transparent huge pages (Linux)\n"
+    "  --prefault         Pre-fault compiler memory on a background thread (Linux)\n"
     "  --output           <path>\n"
     "  --binary-format    [pe32:cli, pe32:gui]\n"
     "    Set output binary executable format;"
@@ -50,12 +53,21 @@ int main(s32 argc, char **argv) {
   Executable_Type win32_executable_type = Executable_Type_Cli;
 
   Mass_Cli_Mode mode = Mass_Cli_Mode_Compile;
+  bool print_stats = false;
+  bool use_huge_pages = false;
+  bool use_prefault = false;
   char *raw_file_path = 0;
   char *raw_output_path = 0;
   for (s32 i = 1; i < argc; ++i) {
     char *arg = argv[i];
     if (strcmp(arg, "--run") == 0) {
       mode = Mass_Cli_Mode_Run;
+    } else if (strcmp(arg, "--stats") == 0) {
+      print_stats = true;
+    } else if (strcmp(arg, "--huge-pages") == 0) {
+      use_huge_pages = true;
+    } else if (strcmp(arg, "--prefault") == 0) {
+      use_prefault = true;
     } else if (strcmp(arg, "--script") == 0) {
       mode = Mass_Cli_Mode_Script;
     } else if (strcmp(arg, "--output") == 0) {
@@ -110,6 +122,13 @@ int main(s32 argc, char **argv) {
 
   Compilation compilation;
   compilation_init(&compilation, os);
+  if (use_huge_pages) {
+    virtual_memory_buffer_enable_huge_pages(&compilation.allocation_buffer);
+    virtual_memory_buffer_enable_huge_pages(&compilation.temp_buffer);
+  }
+  #if defined(__linux__)
+  if (use_prefault) virtual_memory_buffer_enable_warmup(&compilation.allocation_buffer);
+  #endif
   Mass_Context context = mass_context_from_compilation(&compilation);
 
   program_load_file_module_into_root_scope(&context, slice_literal("std/prelude"));
@@ -122,6 +141,7 @@ int main(s32 argc, char **argv) {
     if (mass_has_error(&context)) {
       return mass_cli_print_error(&compilation, context.result);
     }
+    if (print_stats) compilation_print_counters(&compilation);
     return 0;
   }
 
@@ -185,11 +205,13 @@ int main(s32 argc, char **argv) {
       fn_type_opaque main = value_as_function(jit.program, main_value);
       main();
       if (mass_has_error(&context)) goto cli_run_error;
+      if (print_stats) compilation_print_counters(&compilation);
       return 0;
 
       cli_run_error:
       return mass_cli_print_error(&compilation, context.result);
     }
   }
+  if (print_stats) compilation_print_counters(&compilation);
   return 0;
 }
@@ -685,7 +685,7 @@ print_natvis(
       fprintf(file, "      <Variable Name=\"i\" InitialValue=\"0\" />\n");
       fprintf(file, "      <Size>capacity</Size>\n");
       fprintf(file, "      <Loop>\n");
-      fprintf(file, "        <If Condition=\"entries[i].occupied\">\n");
+      fprintf(file, "        <If Condition=\"control[i] &lt; 0x80\">\n");
       fprintf(file, "          <Item Name=\"{entries[i].key->name.bytes,[entries[i].key->name.length]s}\">entries[i].value</Item>\n");
       fprintf(file, "        </If>\n");
       fprintf(file, "        <Exec>i++</Exec>\n");
@@ -1248,6 +1248,9 @@ main(void) {
   push_type(type_struct("Source_File", (Struct_Item[]){
     { "Slice", "path" },
     { "Slice", "text" },
+    // Offsets of the first byte of each line, built on the first position lookup
+    { "u32 *", "line_starts" },
+    { "u64", "line_count" },
   }));
 
   export_compiler(push_type(type_struct("Source_Range", (Struct_Item[]){
@@ -1298,6 +1301,18 @@ main(void) {
     { "Slice", "name" },
   })));
 
+  // Symbols made by `mass_ensure_symbol` are allocated with extra bookkeeping that
+  // is kept away from Mass code. Scopes only ever store interned symbols.
+  push_type(type_struct("Interned_Symbol", (Struct_Item[]){
+    { "Symbol", "symbol" },
+    // Dense per-compilation index assigned on interning
+    { "u32", "id" },
+    // Incremented for every new scope entry defined for this symbol to invalidate cached lookups
+    { "u32", "definition_count" },
+    // Bitmask of Operator_Fixity values this symbol was ever declared as an operator with
+    { "u32", "operator_fixities" },
+  }));
+
   export_compiler(push_type(type_struct("Group_Paren", (Struct_Item[]){
     { "Value_View", "children" },
   })));
@@ -1311,10 +1326,28 @@ main(void) {
     { "Ast_Statement *", "next" },
   })));
 
-  export_compiler(push_type(type_struct("Ast_Block", (Struct_Item[]){
+  // Packed output of the tokenizer, one entry per token in each of the arrays.
+  // `payloads` hold a decoded number, an interned `Symbol *` or for the `{`
+  // the index of the matching `}` depending on the tag.
+  push_type(type_struct("Token_Stream", (Struct_Item[]){
+    { "const Source_File *", "file" },
+    { "u8 *", "tags" },
+    { "u32 *", "offsets" },
+    { "u32 *", "lengths" },
+    { "u64 *", "payloads" },
+    { "u32", "count" },
+    { "u32", "_count_padding" },
+  }));
+
+  // Not exported because nested blocks keep their statements as tokens until they are
+  // parsed, so Mass code would see an empty block unless it went through the compiler
+  push_type(type_struct("Ast_Block", (Struct_Item[]){
     { "Ast_Statement *", "first_statement" },
     { "Ast_Statement *", "last_statement" },
-  })));
+    { "const Token_Stream *", "lazy_stream" },
+    { "u32", "lazy_from_token" },
+    { "u32", "lazy_to_token" },
+  }));
 
   export_compiler(push_type(type_struct("Group_Square", (Struct_Item[]){
     { "Value_View", "children" },
@@ -1335,6 +1368,9 @@ main(void) {
     { "Slice", "name" },
     { "u32", "base_rva" },
     { "Section_Permissions", "permissions" },
+    // When the program memory is mapped a second time for execution this is the distance
+    // from `buffer.memory` to that mapping, otherwise it is zero :DualMappedJit
+    { "s64", "execution_offset" },
   }));
 
   push_type(type_struct("Program_Memory", (Struct_Item[]){
@@ -1624,12 +1660,26 @@ main(void) {
 
   push_type(type_struct("Scope_Entry", (Struct_Item[]){
     { "Value *", "value" },
+    { "const Symbol *", "symbol" },
     { "Slice", "name" },
     { "Epoch", "epoch" },
     { "const Value *", "latest_forced_value" },
     { "Source_Range", "source_range" },
   }));
 
+  // Entries of consecutive imperative scopes are appended into a shared chunk.
+  // `index` maps a symbol to its latest entry and `shadowed` links each entry to
+  // an earlier one with the same symbol; both store `entry index + 1`.
+  push_type(type_struct("Imperative_Scope_Chunk", (Struct_Item[]){
+    { "u32", "count" },
+    { "u32", "capacity" },
+    { "u32", "index_mask" },
+    { "u32", "_index_mask_padding" },
+    { "Scope_Entry *", "entries" },
+    { "u16 *", "shadowed" },
+    { "u16 *", "index" },
+  }));
+
   push_type(type_hash_map("Operator_Map", {
     .key_type = "const Symbol *",
     .value_type = "Operator *",
@@ -1644,11 +1694,28 @@ main(void) {
     .equal_function = "const_void_pointer_equal",
   }));
 
+  push_type(type_enum("Declarative_Scope_Layout", (Enum_Type_Item[]){
+    { "Flat", 0 },
+    { "Map", 1 },
+    { "Direct", 2 },
+  }));
+
   export_compiler(push_type(add_common_fields(type_union("Scope", (Struct_Type[]){
     struct_fields("Imperative", (Struct_Item[]){
-      { "Scope_Entry", "entry" },
+      // Only the first `count` entries of the chunk are visible from this scope
+      { "Imperative_Scope_Chunk *", "chunk" },
+      { "u32", "count" },
+      { "u32", "_count_padding" },
     }),
     struct_fields("Declarative", (Struct_Item[]){
+      { "Declarative_Scope_Layout", "layout" },
+      { "u32", "count" },
+      { "u32", "capacity" },
+      { "u32", "_capacity_padding" },
+      // Flat: `entries[i]` is defined for symbol with id `flat_ids[i]`
+      // Direct: `entries` is indexed by symbol id
+      { "Scope_Entry * *", "entries" },
+      { "u32 *", "flat_ids" },
       { "Scope_Map *", "map" },
     }),
   }), (Struct_Item[]){
@@ -1656,9 +1723,34 @@ main(void) {
     { "const Scope *", "parent" },
   })));
 
-  push_type(type_struct("Overload", (Struct_Item[]){
+  push_type(type_enum("Overload_First_Parameter", (Enum_Type_Item[]){
+    { "Any", 0 },
+    { "Runtime", 1 },
+    { "Exact_Static", 2 },
+    { "Generic_Static", 3 },
+  }));
+
+  // :OverloadPrefilter
+  push_type(type_struct("Overload_Candidate", (Struct_Item[]){
     { "Value *", "value" },
-    { "Value *", "next" },
+    { "Overload_First_Parameter", "first_parameter" },
+    { "u32", "requires_compile_time_arguments" },
+    // Only set for `Runtime` and `Exact_Static` first parameters
+    { "u64", "first_parameter_kind" },
+  }));
+
+  push_type(type_struct("Overload_Bucket", (Struct_Item[]){
+    { "u32", "from" },
+    { "u32", "to" },
+  }));
+
+  push_type(type_struct("Overload", (Struct_Item[]){
+    // Definitions from the newest to the oldest
+    { "Array_Value_Ptr", "values" },
+    // Built on the first match once all of the values are forced.
+    // `buckets[n]` is a range of `candidates` that accept `n` arguments.
+    { "Array_Overload_Candidate", "candidates" },
+    { "Array_Overload_Bucket", "buckets" },
   }));
 
   push_type(type_struct("Undecidable_Match", (Struct_Item[]){
@@ -1822,6 +1914,24 @@ main(void) {
   push_type(type_struct("Function_Specialization", (Struct_Item[]){
     { "Array_Function_Parameter", "parameters" },
     { "Function_Info *", "info" },
+    // `index + 1` of an older specialization with the same hash or 0 if none
+    { "u64", "previous_with_same_hash" },
+  }));
+
+  // Maps a hash of (info, calling convention, program) to `index + 1` of an instance
+  push_type(type_hash_map("Function_Instance_Map", {
+    .key_type = "u64",
+    .value_type = "u64",
+    .hash_function = "hash_u64",
+    .equal_function = "u64_equal",
+  }));
+
+  // Maps a hash of specialized parameters to `index + 1` of the newest specialization
+  push_type(type_hash_map("Function_Specialization_Map", {
+    .key_type = "u64",
+    .value_type = "u64",
+    .hash_function = "hash_u64",
+    .equal_function = "u64_equal",
   }));
 
   export_compiler(push_type(type_struct("Function_Header", (Struct_Item[]){
@@ -1838,6 +1948,8 @@ main(void) {
     { "u64 *", "overload_lock_count"},
     { "Array_Value_Ptr", "instances"},
     { "Array_Function_Specialization", "specializations"},
+    { "Function_Specialization_Map *", "specialization_map"},
+    { "Function_Instance_Map *", "instance_map"},
   })));
 
   push_type(type_enum("Function_Call_Parameter_Flags", (Enum_Type_Item[]){
@@ -2092,6 +2204,7 @@ main(void) {
     { "const Descriptor *", "args_descriptor" },
     { "const Function_Info *", "original_info" },
     { "Mass_Trampoline_Proc", "proc"},
+    { "const void *", "direct_proc"},
   }));
 
   push_type(type_hash_map("Struct_Field_Set", {
@@ -2101,6 +2214,18 @@ main(void) {
     .equal_function = "const_void_pointer_equal",
   }));
 
+  push_type(type_hash_map("Struct_Field_Name_Map", {
+    .key_type = "Slice",
+    .value_type = "u64",
+  }));
+
+  push_type(type_hash_map("Struct_Field_Index_Map", {
+    .key_type = "const Descriptor *",
+    .value_type = "Struct_Field_Name_Map *",
+    .hash_function = "hash_pointer",
+    .equal_function = "const_void_pointer_equal",
+  }));
+
   push_type(type_hash_map("Slice_Set", {
     .key_type = "Slice",
     .value_type = "u64",
@@ -2153,6 +2278,9 @@ main(void) {
     { "Jit_Import_Library_Handle_Map *", "import_library_handles" },
     { "Jit_Counters", "previous_counts" },
     { "void *", "platform_specific_payload" },
+    { "Virtual_Memory_Buffer", "thunk_buffer" },
+    { "Allocator *", "thunk_allocator" },
+    { "u64", "thunk_buffer_floor" },
   }));
 
   push_type(type_hash_map("Static_Pointer_Length_Map", {
@@ -2169,6 +2297,18 @@ main(void) {
     .equal_function = "const_void_pointer_equal",
   }));
 
+  push_type(type_struct("Descriptor_Intern_Entry", (Struct_Item[]){
+    { "const Descriptor *", "descriptor" },
+    { "Descriptor_Intern_Entry *", "next" },
+  }));
+
+  push_type(type_hash_map("Descriptor_Intern_Map", {
+    .key_type = "u64",
+    .value_type = "Descriptor_Intern_Entry *",
+    .hash_function = "hash_u64",
+    .equal_function = "u64_equal",
+  }));
+
   push_type(type_hash_map("Intrinsic_Proc_Cache_Map", {
     .key_type = "const Value *",
     .value_type = "Mass_Intrinsic_Proc",
@@ -2204,6 +2344,75 @@ main(void) {
     { "const Symbol *", "operator_dot_dot_dot" },
   }));
 
+  set_flags(push_type(type_c_opaque("File_Mapping")), Meta_Type_Flags_No_C_Type);
+
+  push_type(type_struct("Scope_Lookup_Cache_Entry", (Struct_Item[]){
+    { "const Scope *", "scope" },
+    { "const Symbol *", "symbol" },
+    { "Scope_Entry *", "entry" },
+    { "u64", "definition_count" },
+  }));
+
+  // Entries with the same signature hash are chained through `next`
+  push_type(type_struct("Overload_Match_Cache_Entry", (Struct_Item[]){
+    { "const Value *", "overload_set" },
+    { "const Program *", "program" },
+    { "Array_Resolved_Function_Parameter", "arguments" },
+    { "Overload_Match", "match" },
+    { "Overload_Match_Cache_Entry *", "next" },
+  }));
+
+  push_type(type_hash_map("Overload_Match_Cache_Map", {
+    .key_type = "u64",
+    .value_type = "Overload_Match_Cache_Entry *",
+    .hash_function = "hash_u64",
+    .equal_function = "u64_equal",
+  }));
+
+  // A symbol referenced by a memoized compile-time evaluation and what it resolved to.
+  // `bits` holds the immediate bits, the static pointer or, for a definition that
+  // was not forced yet, the address of the lazy value. Unresolved symbols have no descriptor.
+  push_type(type_struct("Compile_Time_Eval_Input", (Struct_Item[]){
+    { "const Symbol *", "symbol" },
+    { "const Descriptor *", "descriptor" },
+    { "u64", "bits" },
+  }));
+
+  // Entries with the same source range and inputs hash are chained through `next`
+  push_type(type_struct("Compile_Time_Eval_Cache_Entry", (Struct_Item[]){
+    { "Source_Range", "source_range" },
+    { "Array_Compile_Time_Eval_Input", "inputs" },
+    { "const Value *", "result" },
+    { "Compile_Time_Eval_Cache_Entry *", "next" },
+  }));
+
+  push_type(type_hash_map("Compile_Time_Eval_Cache_Map", {
+    .key_type = "u64",
+    .value_type = "Compile_Time_Eval_Cache_Entry *",
+    .hash_function = "hash_u64",
+    .equal_function = "u64_equal",
+  }));
+
+  push_type(type_struct("Compilation_Counters", (Struct_Item[]){
+    { "u64", "scope_lookup_cache_hits" },
+    { "u64", "scope_lookup_cache_misses" },
+    { "u64", "overload_match_cache_hits" },
+    { "u64", "overload_match_cache_misses" },
+    { "u64", "function_instance_count" },
+    { "u64", "descriptor_intern_hits" },
+    { "u64", "descriptor_intern_misses" },
+    { "u64", "compile_time_eval_cache_hits" },
+    { "u64", "compile_time_eval_cache_misses" },
+    { "u64", "compile_time_eval_interpreted_count" },
+    { "u64", "compile_time_eval_jit_count" },
+    { "u64", "trampoline_direct_call_count" },
+    { "u64", "trampoline_struct_call_count" },
+    { "u64", "jit_commit_count" },
+    { "u64", "jit_skipped_commit_count" },
+    { "u64", "jit_reclaimed_thunk_count" },
+    { "u64", "jit_reclaimed_thunk_byte_count" },
+  }));
+
   export_compiler(push_type(type_struct("Compilation", (Struct_Item[]){
     { "Virtual_Memory_Buffer", "temp_buffer" },
     { "Allocator *", "temp_allocator" },
@@ -2217,10 +2426,23 @@ main(void) {
     { "Scope *", "root_scope" },
     { "Program *", "runtime_program" },
     { "Mass_Result *", "result" },
+    { "Array_File_Mapping", "source_file_mappings" },
     { "Symbol_Map *", "symbol_cache_map" },
+    { "u64", "symbol_count" },
+    { "Scope_Lookup_Cache_Entry *", "scope_lookup_cache" },
+    { "Compilation_Counters", "counters" },
+    { "Overload_Match_Cache_Map *", "overload_match_cache_map" },
+    { "Compile_Time_Eval_Cache_Map *", "compile_time_eval_cache_map" },
+    // Number of function literals currently locked for overload matching :OverloadLock
+    { "u64", "overload_lock_depth" },
+    // Literals that have at least one instance, used to report instantiation bloat
+    { "Array_Function_Literal_Ptr", "instantiated_literals" },
     { "Operator_Symbol_Map *", "prefix_operator_symbol_map" },
     { "Operator_Symbol_Map *", "infix_or_suffix_operator_symbol_map" },
     { "Descriptor_Pointer_To_Cache_Map *", "descriptor_pointer_to_cache_map"},
+    { "Descriptor_Intern_Map *", "descriptor_intern_map"},
+    // Lazily built name lookup for structs with many fields :StructFieldIndex
+    { "Struct_Field_Index_Map *", "struct_field_index_map"},
     { "Intrinsic_Proc_Cache_Map *", "intrinsic_proc_cache_map" },
     { "Common_Symbols", "common_symbols" },
     { "Operator", "apply_operator" },
@@ -2313,6 +2535,7 @@ main(void) {
   export_compiler_custom_name("pointer_to", push_type(type_intrinsic("mass_pointer_to")));
   export_compiler_custom_name("pointer_to_type", push_type(type_intrinsic("mass_pointer_to_type")));
   export_compiler_custom_name("eval", push_type(type_intrinsic("mass_eval")));
+  export_compiler_custom_name("eval_uncached", push_type(type_intrinsic("mass_eval_uncached")));
   export_compiler_custom_name("inline_module", push_type(type_intrinsic("mass_inline_module")));
   export_compiler_custom_name("c_struct", push_type(type_intrinsic("mass_c_struct")));
   export_compiler_custom_name("exports", push_type(type_intrinsic("mass_exports")));
@@ -2379,6 +2602,13 @@ main(void) {
     })
   ));
 
+  export_compiler(push_type(
+    type_function(Default, "descriptor_intern", "const Descriptor *", (Argument_Type[]){
+      { "Compilation *", "compilation" },
+      { "const Descriptor *", "descriptor" },
+    })
+  ));
+
   export_compiler(push_type(
     type_function(Default, "scope_make_imperative", "Scope *", (Argument_Type[]){
       { "const Allocator *", "allocator" },
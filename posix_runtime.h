@@ -4,6 +4,11 @@
 #include "program.h"
 #include <sys/mman.h>
 #include <dlfcn.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/memfd.h>
+#endif
 
 static int
 posix_section_permissions_to_mprotect_flags(
@@ -53,6 +58,74 @@ posix_section_protect_from(
   }
 }
 
+#if defined(__linux__)
+// :DualMappedJit
+// Backs the program memory with a memfd that is mapped twice. The compiler writes
+// through `buffer->memory` which is always writable, while the jitted code runs from
+// the second mapping which gets the section permissions once, at startup. This avoids
+// switching the pages between writable and executable on every JIT, which costs
+// a couple of syscalls and a TLB shootdown each time.
+// Returns the offset from the writable to the executable mapping or 0 on failure,
+// in which case the caller should fall back to a regular single mapping.
+static s64
+posix_program_memory_init_dual_mapped(
+  Virtual_Memory_Buffer *buffer,
+  u64 capacity,
+  void *execution_address
+) {
+  int fd = (int)syscall(SYS_memfd_create, "mass_jit", MFD_CLOEXEC);
+  if (fd < 0) return 0;
+  // The file is sparse, so only pages that are touched through either mapping use memory
+  if (0 != ftruncate(fd, (off_t)capacity)) {
+    close(fd);
+    return 0;
+  }
+  int flags = MAP_SHARED | MAP_NORESERVE;
+  s8 *writable = mmap(0, capacity, PROT_READ | PROT_WRITE, flags, fd, 0);
+  if (writable == MAP_FAILED) {
+    close(fd);
+    return 0;
+  }
+  s8 *executable = mmap(execution_address, capacity, PROT_NONE, flags, fd, 0);
+  // Mappings keep their own reference to the file
+  close(fd);
+  if (executable == MAP_FAILED) {
+    munmap(writable, capacity);
+    return 0;
+  }
+  *buffer = (Virtual_Memory_Buffer) {
+    .capacity = capacity,
+    .memory = writable,
+    .commit_step_byte_size = 16 * memory_page_size(),
+  };
+  return executable - writable;
+}
+
+static void
+posix_program_memory_protect_execution_view(
+  Program_Memory *memory
+) {
+  Section *sections[] = {&memory->code, &memory->rw_data, &memory->ro_data};
+  for (u64 i = 0; i < countof(sections); ++i) {
+    Section *section = sections[i];
+    int protect_flags = posix_section_permissions_to_mprotect_flags(section->permissions);
+    // Code also needs to be readable for any rip-relative constants stored with it
+    if (protect_flags & PROT_EXEC) protect_flags |= PROT_READ;
+    void *address = section->buffer.memory + section->execution_offset;
+    if (0 != mprotect(address, section->buffer.capacity, protect_flags)) {
+      panic("UNREACHED");
+    }
+  }
+}
+
+static void
+posix_program_memory_deinit_execution_view(
+  Program_Memory *memory
+) {
+  munmap(memory->buffer.memory + memory->code.execution_offset, memory->buffer.capacity);
+}
+#endif
+
 void *posix_load_library(const char *name) { return dlopen(name, RTLD_LAZY); }
 void *posix_load_symbol(void *handle, const char *name) { return dlsym(handle, name); }
 
@@ -70,14 +143,20 @@ posix_program_jit(
   Program_Memory *memory = &jit->program->memory;
   Virtual_Memory_Buffer *code_buffer = &memory->code.buffer;
   Virtual_Memory_Buffer *ro_data_buffer = &memory->ro_data.buffer;
+  // :DualMappedJit The writable mapping never changes protection
+  bool is_dual_mapped = memory->code.execution_offset != 0;
 
   // Memory protection works on per-page level so with incremental JIT there are two options:
   // 1. Waste memory every time we do JIT due to padding to page size.
   // 2. Switch memory back to writable before new writes.
   // On Windows options 2 is preferable, however some unix-like system disallow multiple
   // transitions between writable and executable so might have to resort to 1 there.
-  u64 code_protected_size = posix_buffer_ensure_last_page_is_writable(code_buffer);
-  u64 ro_data_protected_size = posix_buffer_ensure_last_page_is_writable(ro_data_buffer);
+  u64 code_protected_size = 0;
+  u64 ro_data_protected_size = 0;
+  if (!is_dual_mapped) {
+    code_protected_size = posix_buffer_ensure_last_page_is_writable(code_buffer);
+    ro_data_protected_size = posix_buffer_ensure_last_page_is_writable(ro_data_buffer);
+  }
 
   program_jit_imports(compilation, jit, ro_data_buffer, &posix_library_load_callbacks);
   if (mass_has_error(compilation)) return;
@@ -95,11 +174,13 @@ posix_program_jit(
   // and can patch all the label locations
   program_patch_labels(program);
 
-  // Setup permissions for read-only data segment
-  posix_section_protect_from(&memory->ro_data, ro_data_protected_size);
+  if (!is_dual_mapped) {
+    // Setup permissions for read-only data segment
+    posix_section_protect_from(&memory->ro_data, ro_data_protected_size);
 
-  // Setup permissions for the code segment
-  posix_section_protect_from(&memory->code, code_protected_size);
+    // Setup permissions for the code segment
+    posix_section_protect_from(&memory->code, code_protected_size);
+  }
 
   program_jit_resolve_relocations(jit);
 }
@@ -1,6 +1,12 @@
 #ifndef PRELUDE_H
 #define PRELUDE_H
 
+// Exposes `syscall` and other Linux specific declarations that are hidden with -std=c11.
+// This only works if this file is included before any system header.
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #ifndef PRELUDE_NO_WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -610,6 +616,61 @@ static_assert(
 
 #endif
 
+//////////////////////////////////////////////////////////////////////////////
+// CPU Features
+//////////////////////////////////////////////////////////////////////////////
+
+#if defined(__x86_64__) || defined(_M_AMD64)
+#define PRELUDE_X86_64 1
+#endif
+
+// GCC and Clang require functions using instructions beyond the baseline
+// to be explicitly marked, MSVC allows any intrinsics everywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define PRELUDE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PRELUDE_TARGET_AVX2
+#endif
+
+static inline bool
+system_cpu_supports_avx2() {
+  static s32 supported = -1;
+  if (supported == -1) {
+    supported = 0;
+    #if defined(PRELUDE_X86_64) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool os_saves_ymm = false;
+    // OSXSAVE bit tells us that we can ask the OS if it preserves YMM registers
+    if (info[2] & (1 << 27)) {
+      os_saves_ymm = (_xgetbv(0) & 0x6) == 0x6;
+    }
+    __cpuidex(info, 7, 0);
+    supported = os_saves_ymm && (info[1] & (1 << 5));
+    #elif defined(PRELUDE_X86_64)
+    __builtin_cpu_init();
+    supported = !!__builtin_cpu_supports("avx2");
+    #endif
+  }
+  return !!supported;
+}
+
+static inline u32
+system_logical_processor_count() {
+  static u32 count = 0;
+  if (!count) {
+    #ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = info.dwNumberOfProcessors;
+    #else
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    count = online > 0 ? (u32)online : 1;
+    #endif
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Allocator
 //////////////////////////////////////////////////////////////////////////////
@@ -2833,6 +2894,18 @@ utf16_null_terminated_to_utf8(
 // Virtual Memory Buffer
 //////////////////////////////////////////////////////////////////////////////
 
+#if defined(__linux__)
+#include <semaphore.h>
+// Only available since Linux 5.14 so might be missing from older headers
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+// How far ahead of the highest requested size the warm up thread pre-faults pages.
+// Committed steps can be very large, so warming them up completely would fault in
+// a lot of memory that a short compilation never touches.
+#define VIRTUAL_MEMORY_BUFFER_WARM_UP_WINDOW_BYTE_SIZE (1024 * 1024)
+#endif
+
 typedef struct {
   u64 capacity;
   u64 occupied;
@@ -2842,6 +2915,7 @@ typedef struct {
   void *warm_up_thread;
   void *warm_up_event;
   Atomic_u64 warmed_up;
+  Atomic_u64 warm_up_requested;
 } Virtual_Memory_Buffer;
 
 
@@ -2894,6 +2968,16 @@ virtual_memory_buffer_deinit(
   }
   VirtualFree(buffer->memory, 0, MEM_RELEASE);
 #else
+  #if defined(__linux__)
+  if (buffer->warm_up_thread) {
+    // The thread must be done touching the memory before it is unmapped
+    atomic_u64_exchange(&buffer->warmed_up, UINT64_MAX);
+    sem_post(buffer->warm_up_event);
+    thread_join((Thread){.native_handle = buffer->warm_up_thread});
+    sem_destroy(buffer->warm_up_event);
+    allocator_deallocate(allocator_default, buffer->warm_up_event, sizeof(sem_t));
+  }
+  #endif
   munmap(buffer->memory, buffer->capacity);
 #endif
   *buffer = (Virtual_Memory_Buffer){0};
@@ -2905,6 +2989,14 @@ virtual_memory_buffer_ensure_committed(
   u64 size
 ) {
   assert(buffer->capacity >= size);
+  #if defined(__linux__)
+  // Signal again once half of the warmed up window is used
+  if (buffer->warm_up_event && size > atomic_u64_load(&buffer->warm_up_requested)) {
+    u64 requested = size + VIRTUAL_MEMORY_BUFFER_WARM_UP_WINDOW_BYTE_SIZE / 2;
+    atomic_u64_exchange(&buffer->warm_up_requested, requested);
+    sem_post(buffer->warm_up_event);
+  }
+  #endif
   if (size > buffer->committed) {
     u64 required_to_commit = u64_align(size, buffer->commit_step_byte_size);
     void *commit_pointer = buffer->memory + buffer->committed;
@@ -2913,6 +3005,10 @@ virtual_memory_buffer_ensure_committed(
     #ifdef _WIN32
       VirtualAlloc(commit_pointer, commit_size, MEM_COMMIT, PAGE_READWRITE);
       SetEvent(buffer->warm_up_event);
+    #elif defined(__linux__)
+      if (!buffer->warm_up_event) {
+        madvise(commit_pointer, commit_size, MADV_WILLNEED);
+      }
     #else
       madvise(commit_pointer, commit_size, MADV_WILLNEED);
     #endif
@@ -2973,6 +3069,39 @@ virtual_memory_buffer_warm_up_proc(
     }
   }
 }
+#elif defined(__linux__)
+static void
+virtual_memory_buffer_warm_up_proc(
+  void *data
+) {
+  Virtual_Memory_Buffer *buffer = data;
+  const u64 page_size = s32_to_u64(memory_page_size());
+  bool can_populate = true;
+  while (true) {
+    while (sem_wait(buffer->warm_up_event) != 0) {} // Retry on EINTR
+    u64 original_warmed_up = atomic_u64_load(&buffer->warmed_up);
+    if (original_warmed_up >= buffer->capacity) return;
+    u64 requested = atomic_u64_load(&buffer->warm_up_requested);
+    u64 warmed_up = u64_align(requested + VIRTUAL_MEMORY_BUFFER_WARM_UP_WINDOW_BYTE_SIZE / 2, page_size);
+    warmed_up = u64_min(warmed_up, buffer->capacity);
+    if (original_warmed_up >= warmed_up) continue;
+    // We do not care if this fails, just not that we overwrite the value
+    atomic_u64_compare_exchange(&buffer->warmed_up, original_warmed_up, warmed_up);
+
+    s8 *start_address = buffer->memory + original_warmed_up;
+    u64 delta = warmed_up - original_warmed_up;
+    // Populating faults the pages in as writable without touching their contents
+    // so it is safe to do while the main thread is already writing to them
+    if (can_populate && madvise(start_address, delta, MADV_POPULATE_WRITE) == 0) continue;
+    // Older kernels do not support populating, so touch every page instead. Unlike Windows,
+    // a read would only map the shared zero page, so this has to be a write. An atomic
+    // add of zero does not race with the writes from the main thread.
+    can_populate = false;
+    for (u64 offset = 0; offset < delta; offset += page_size) {
+      __atomic_fetch_add((u8 *)start_address + offset, 0, __ATOMIC_RELAXED);
+    }
+  }
+}
 #endif
 
 static inline void
@@ -2990,6 +3119,30 @@ virtual_memory_buffer_enable_warmup(
   buffer->warm_up_thread = (void *)CreateThread(
     0, 0, virtual_memory_buffer_warm_up_proc, buffer, 0, &(DWORD){0}
   );
+#elif defined(__linux__)
+  // Moves the page faults for fresh pages off the main thread, which only helps
+  // when there is a spare core for the warm up thread to run on
+  sem_t *event = allocator_allocate(allocator_default, sem_t);
+  if (sem_init(event, 0, 1) != 0) {
+    allocator_deallocate(allocator_default, event, sizeof(sem_t));
+    return;
+  }
+  buffer->warm_up_event = event;
+  atomic_u64_exchange(&buffer->warm_up_requested, buffer->occupied);
+  buffer->warm_up_thread = thread_make(virtual_memory_buffer_warm_up_proc, buffer).native_handle;
+#endif
+}
+
+// Asks the kernel to back the buffer with transparent huge pages. This reduces
+// page faults and TLB misses at the cost of memory usage, so it is opt-in.
+static inline void
+virtual_memory_buffer_enable_huge_pages(
+  Virtual_Memory_Buffer *buffer
+) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  madvise(buffer->memory, buffer->capacity, MADV_HUGEPAGE);
+#else
+  (void)buffer;
 #endif
 }
 
@@ -3516,6 +3669,125 @@ fixed_buffer_from_file_internal(
     __VA_ARGS__\
   })
 
+//////////////////////////////////////////////////////////////////////////////
+// File Mapping
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+// Read-only view of a whole file, backed directly by the OS page cache.
+// Unlike `fixed_buffer_from_file` nothing is copied; the pages are faulted
+// in on first access. Empty files are not mapped at all and produce an
+// empty `contents` slice with a non-null pointer.
+typedef struct {
+  Slice contents;
+} File_Mapping;
+
+static bool
+file_mapping_open(
+  Slice file_path,
+  File_Mapping *out_mapping,
+  File_Read_Error *error
+) {
+  // Allows to not check for null when reporting
+  static File_Read_Error dummy_error;
+  if (!error) error = &dummy_error;
+  *error = File_Read_Error_None;
+  *out_mapping = (File_Mapping){ .contents = { .bytes = "", .length = 0 } };
+
+#ifdef _WIN32
+  u16 *file_path_utf16 = utf8_to_utf16_null_terminated(allocator_default, file_path);
+  HANDLE file_handle = CreateFileW(
+    file_path_utf16,
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    0,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    0
+  );
+  allocator_deallocate(
+    allocator_default, file_path_utf16,
+    utf16_string_length(file_path_utf16) + sizeof(u16)
+  );
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    *error = File_Read_Error_Failed_To_Open;
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size)) {
+    CloseHandle(file_handle);
+    *error = File_Read_Error_Failed_To_Read;
+    return false;
+  }
+  if (file_size.QuadPart == 0) {
+    CloseHandle(file_handle);
+    return true;
+  }
+  HANDLE mapping_handle = CreateFileMappingW(file_handle, 0, PAGE_READONLY, 0, 0, 0);
+  // The view keeps a reference to the underlying file so handles can be closed right away
+  CloseHandle(file_handle);
+  if (!mapping_handle) {
+    *error = File_Read_Error_Failed_To_Read;
+    return false;
+  }
+  void *address = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping_handle);
+  if (!address) {
+    *error = File_Read_Error_Failed_To_Read;
+    return false;
+  }
+  out_mapping->contents = (Slice){ .bytes = address, .length = file_size.QuadPart };
+  return true;
+#else
+  char *file_path_null_terminated =
+    slice_to_c_string(allocator_default, file_path);
+  int file_descriptor = open(file_path_null_terminated, O_RDONLY);
+  allocator_deallocate(
+    allocator_default, file_path_null_terminated, file_path.length + 1
+  );
+  if (file_descriptor < 0) {
+    *error = File_Read_Error_Failed_To_Open;
+    return false;
+  }
+  struct stat st;
+  if (fstat(file_descriptor, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(file_descriptor);
+    *error = File_Read_Error_Failed_To_Open;
+    return false;
+  }
+  if (st.st_size == 0) {
+    close(file_descriptor);
+    return true;
+  }
+  void *address = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  // The mapping keeps a reference to the underlying file so the descriptor can be closed right away
+  close(file_descriptor);
+  if (address == MAP_FAILED) {
+    *error = File_Read_Error_Failed_To_Read;
+    return false;
+  }
+  out_mapping->contents = (Slice){ .bytes = address, .length = st.st_size };
+  return true;
+#endif
+}
+
+static void
+file_mapping_close(
+  File_Mapping *mapping
+) {
+  if (mapping->contents.length) {
+    #ifdef _WIN32
+    UnmapViewOfFile(mapping->contents.bytes);
+    #else
+    munmap((void *)mapping->contents.bytes, mapping->contents.length);
+    #endif
+  }
+  *mapping = (File_Mapping){0};
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Bucket Buffer
 //////////////////////////////////////////////////////////////////////////////
@@ -3830,27 +4102,108 @@ hash_pointer(
   return hash_u64((u64)address);
 }
 
+static inline u64
+hash_multiply_wide(
+  u64 a,
+  u64 b,
+  u64 *out_high
+) {
+  #if defined(_MSC_VER) && !defined(__clang__) && defined(PRELUDE_X86_64)
+  return _umul128(a, b, out_high);
+  #elif defined(__SIZEOF_INT128__)
+  unsigned __int128 product = (unsigned __int128)a * b;
+  *out_high = (u64)(product >> 64);
+  return (u64)product;
+  #else
+  u64 a_high = a >> 32, a_low = (u32)a;
+  u64 b_high = b >> 32, b_low = (u32)b;
+  u64 high_high = a_high * b_high, high_low = a_high * b_low;
+  u64 low_high = a_low * b_high, low_low = a_low * b_low;
+  u64 middle = (low_low >> 32) + (u32)high_low + low_high;
+  *out_high = high_high + (high_low >> 32) + (middle >> 32);
+  return (middle << 32) | (u32)low_low;
+  #endif
+}
+
+// Full 64x64 -> 128 bit multiplication folded back into 64 bits
+static inline u64
+hash_multiply_mix(
+  u64 a,
+  u64 b
+) {
+  u64 high;
+  u64 low = hash_multiply_wide(a, b, &high);
+  return low ^ high;
+}
+
+static inline u64
+hash_read_u64(
+  const u8 *bytes
+) {
+  u64 result;
+  memcpy(&result, bytes, sizeof(result));
+  return result;
+}
+
+static inline u64
+hash_read_u32(
+  const u8 *bytes
+) {
+  u32 result;
+  memcpy(&result, bytes, sizeof(result));
+  return result;
+}
+
+// A wyhash-style hash. Identifiers are almost always 16 bytes or shorter,
+// so those are read as (possibly overlapping) 4-byte or 3-byte loads
+// and are mixed with just two multiplications.
 static inline u64
 hash_bytes(
   const void *address,
   u64 size
 ) {
-  u64 result = hash_u64(size);
-  if (!size) return result;
-  const u8 *chunk_address = address;
-  const u8 *end_address = chunk_address + size;
-  // TODO probably would be better to align the start address and do u64 loads instead of memcpy
-  for (; chunk_address + 8 < end_address; chunk_address += 8) {
-    u64 chunk;
-    memcpy(&chunk, chunk_address, 8);
-    result ^= hash_u64(chunk);
-  }
-  if (chunk_address != end_address) {
-    u64 chunk = 0;
-    memcpy(&chunk, chunk_address, end_address - chunk_address);
-    result ^= hash_u64(chunk);
+  static const u64 secret[4] = {
+    UINT64_C(0xa0761d6478bd642f), UINT64_C(0xe7037ed1a0b428db),
+    UINT64_C(0x8ebc6af09c88c6e3), UINT64_C(0x589965cc75374cc3),
+  };
+  const u8 *bytes = address;
+  u64 seed = hash_multiply_mix(secret[0], secret[1]);
+  u64 a = 0;
+  u64 b = 0;
+  if (size <= 16) {
+    if (size >= 4) {
+      u64 middle = (size >> 3) << 2;
+      a = (hash_read_u32(bytes) << 32) | hash_read_u32(bytes + middle);
+      b = (hash_read_u32(bytes + size - 4) << 32) | hash_read_u32(bytes + size - 4 - middle);
+    } else if (size > 0) {
+      a = ((u64)bytes[0] << 16) | ((u64)bytes[size >> 1] << 8) | bytes[size - 1];
+    }
+  } else {
+    u64 remaining = size;
+    if (remaining > 48) {
+      u64 seed_1 = seed;
+      u64 seed_2 = seed;
+      do {
+        seed = hash_multiply_mix(hash_read_u64(bytes) ^ secret[1], hash_read_u64(bytes + 8) ^ seed);
+        seed_1 = hash_multiply_mix(hash_read_u64(bytes + 16) ^ secret[2], hash_read_u64(bytes + 24) ^ seed_1);
+        seed_2 = hash_multiply_mix(hash_read_u64(bytes + 32) ^ secret[3], hash_read_u64(bytes + 40) ^ seed_2);
+        bytes += 48;
+        remaining -= 48;
+      } while (remaining > 48);
+      seed ^= seed_1 ^ seed_2;
+    }
+    while (remaining > 16) {
+      seed = hash_multiply_mix(hash_read_u64(bytes) ^ secret[1], hash_read_u64(bytes + 8) ^ seed);
+      bytes += 16;
+      remaining -= 16;
+    }
+    // The last 16 bytes are always read in full, overlapping the previous block if needed
+    a = hash_read_u64(bytes + remaining - 16);
+    b = hash_read_u64(bytes + remaining - 8);
   }
-  return result;
+  u64 high;
+  u64 low = hash_multiply_wide(a ^ secret[1], b ^ seed, &high);
+  return hash_multiply_mix(low ^ secret[0] ^ size, high ^ secret[1]);
 }
 
 static inline u64
@@ -3875,15 +4228,86 @@ const_void_pointer_equal(
   return a == b;
 }
 
+static inline bool
+u64_equal(
+  u64 a,
+  u64 b
+) {
+  return a == b;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // HashMap
 //////////////////////////////////////////////////////////////////////////////
 
-typedef struct {
-  bool occupied;
-  bool tombstone;
-  u64 hash;
-} Hash_Map_Entry_Bookkeeping;
+// The map is split into a control byte array and an entry array. Each control byte
+// is either EMPTY, DELETED or, for an occupied slot, the low 7 bits of the key hash.
+// Control bytes are probed a group at a time so a single SIMD compare filters
+// out almost all of the entries that do not need a full key comparison.
+#define HASH_MAP_GROUP_WIDTH 16
+#define HASH_MAP_CONTROL_EMPTY ((u8)0x80)
+#define HASH_MAP_CONTROL_DELETED ((u8)0xFE)
+
+static inline bool
+hash_map_control_is_full(
+  u8 control
+) {
+  return control < 0x80;
+}
+
+static inline u8
+hash_map_hash_tag(
+  u64 hash
+) {
+  return (u8)(hash & 0x7f);
+}
+
+static inline u64
+hash_map_hash_group(
+  u64 hash
+) {
+  return hash >> 7;
+}
+
+static inline u32
+hash_map_group_match_tag(
+  const u8 *group,
+  u8 tag
+) {
+  #ifdef PRELUDE_X86_64
+  __m128i control = _mm_load_si128((const __m128i *)group);
+  return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)tag)));
+  #else
+  u32 mask = 0;
+  for (u32 i = 0; i < HASH_MAP_GROUP_WIDTH; ++i) {
+    if (group[i] == tag) mask |= 1u << i;
+  }
+  return mask;
+  #endif
+}
+
+static inline u32
+hash_map_group_match_empty(
+  const u8 *group
+) {
+  return hash_map_group_match_tag(group, HASH_MAP_CONTROL_EMPTY);
+}
+
+static inline u32
+hash_map_group_match_empty_or_deleted(
+  const u8 *group
+) {
+  #ifdef PRELUDE_X86_64
+  // Both EMPTY and DELETED have the high bit set which is exactly what movemask extracts
+  return (u32)_mm_movemask_epi8(_mm_load_si128((const __m128i *)group));
+  #else
+  u32 mask = 0;
+  for (u32 i = 0; i < HASH_MAP_GROUP_WIDTH; ++i) {
+    if (!hash_map_control_is_full(group[i])) mask |= 1u << i;
+  }
+  return mask;
+  #endif
+}
 
 #define hash_map_type_internal(_hash_map_type_, _key_type_, _value_type_)\
   typedef struct _hash_map_type_ _hash_map_type_;\
@@ -3896,17 +4320,10 @@ typedef struct {
     _value_type_ *(*get_by_hash)(_hash_map_type_ *, u64, _key_type_);\
     _value_type_ *(*set_by_hash)(_hash_map_type_ *, u64, _key_type_, _value_type_);\
     void (*delete_by_hash)(_hash_map_type_ *, u64, _key_type_);\
+    u64 (*hash_entry)(const void *);\
   } _hash_map_type_##__Methods;\
   \
   typedef struct _hash_map_type_##__Entry {\
-    /* Needs to be synced with Hash_Map_Entry_Bookkeeping and is provided for convinence */\
-    union {\
-      struct {\
-        bool occupied;\
-        bool tombstone;\
-      };\
-      Hash_Map_Entry_Bookkeeping bookkeeping;\
-    };\
     _key_type_ key;\
     _value_type_ value;\
   } _hash_map_type_##__Entry;\
@@ -3914,58 +4331,141 @@ typedef struct {
   typedef struct _hash_map_type_ {\
     const _hash_map_type_##__Methods *methods;\
     const Allocator *allocator;\
-    u64 hash_mask;\
+    u64 group_mask;\
     u64 capacity_power_of_2;\
     u64 capacity;\
     u64 occupied;\
+    u64 tombstones;\
+    u8 *control;\
     _hash_map_type_##__Entry *entries;\
   } _hash_map_type_;
 
 hash_map_type_internal(Hash_Map_Internal, void *, void *)
 
 static inline u64
-hash_map_get_insert_index_internal(
+hash_map_storage_byte_size(
+  u64 capacity,
+  u64 entry_byte_size
+) {
+  return capacity * (1 + entry_byte_size);
+}
+
+static void
+hash_map_allocate_storage(
   Hash_Map_Internal *map,
-  u64 entry_byte_size,
+  u64 capacity_power_of_2,
+  u64 entry_byte_size
+) {
+  u64 capacity = 1llu << capacity_power_of_2;
+  assert(capacity >= HASH_MAP_GROUP_WIDTH);
+  map->capacity_power_of_2 = capacity_power_of_2;
+  map->capacity = capacity;
+  map->group_mask = capacity / HASH_MAP_GROUP_WIDTH - 1;
+  map->occupied = 0;
+  map->tombstones = 0;
+  // Control bytes and entries share an allocation. Capacity is a multiple of the group
+  // width so the entries that follow the control bytes stay 16-byte aligned.
+  u8 *storage = allocator_allocate_bytes(
+    map->allocator, hash_map_storage_byte_size(capacity, entry_byte_size), HASH_MAP_GROUP_WIDTH
+  );
+  memset(storage, HASH_MAP_CONTROL_EMPTY, capacity);
+  map->control = storage;
+  map->entries = (void *)(storage + capacity);
+}
+
+static inline u64
+hash_map_find_insert_index_internal(
+  const Hash_Map_Internal *map,
   u64 hash
 ) {
+  u64 group_index = hash_map_hash_group(hash) & map->group_mask;
   for (;;) {
-    u64 hash_index = hash & map->hash_mask;
-    Hash_Map_Entry_Bookkeeping *bookkeeping =
-      (void *)((u8 *)map->entries + hash_index * entry_byte_size);
-    if (!bookkeeping->occupied) return hash_index;
-    hash = hash_u64(hash);
+    const u8 *group = map->control + group_index * HASH_MAP_GROUP_WIDTH;
+    u32 mask = hash_map_group_match_empty_or_deleted(group);
+    if (mask) return group_index * HASH_MAP_GROUP_WIDTH + u32_count_trailing_zeros(mask);
+    group_index = (group_index + 1) & map->group_mask;
   }
 }
 
+static inline u64
+hash_map_max_load(
+  u64 capacity
+) {
+  return capacity - capacity / 8;
+}
+
+// Moves all live entries into fresh storage of the requested capacity which also drops all tombstones
 static void
-hash_map_resize(
+hash_map_rehash(
   Hash_Map_Internal *map,
-  u64 entry_byte_size
+  u64 entry_byte_size,
+  u64 capacity_power_of_2
 ) {
   u64 previous_capacity = map->capacity;
-  u64 previous_byte_size = entry_byte_size * map->capacity;
-  map->capacity_power_of_2++;
-  map->capacity = 1llu << map->capacity_power_of_2;
-  map->hash_mask = u64_to_s32(map->capacity - 1);
-  s8 *entries = (s8 *)map->entries;
-  u64 entries_byte_size = entry_byte_size * map->capacity;
-  map->entries = allocator_allocate_bytes(map->allocator, entries_byte_size, 16);
-  memset(map->entries, 0, entries_byte_size);
-
-  // Rehash occupied entries
+  u64 previous_occupied = map->occupied;
+  u8 *previous_control = map->control;
+  u8 *previous_entries = (u8 *)map->entries;
+
+  hash_map_allocate_storage(map, capacity_power_of_2, entry_byte_size);
+
+  // Hashes are not stored so the keys are rehashed to find the new slots
   for (u64 i = 0; i < previous_capacity; ++i) {
-    void *old_entry = entries + i * entry_byte_size;
-    Hash_Map_Entry_Bookkeeping *old_bookkeeping = old_entry;
-    if (old_bookkeeping->occupied && !old_bookkeeping->tombstone) {
-      u64 insertion_index = hash_map_get_insert_index_internal(
-        map, entry_byte_size, old_bookkeeping->hash
-      );
-      void *new_entry = (void *)((s8 *)map->entries + insertion_index * entry_byte_size);
-      memcpy(new_entry, old_entry, entry_byte_size);
+    if (!hash_map_control_is_full(previous_control[i])) continue;
+    void *old_entry = previous_entries + i * entry_byte_size;
+    u64 hash = map->methods->hash_entry(old_entry);
+    u64 index = hash_map_find_insert_index_internal(map, hash);
+    map->control[index] = hash_map_hash_tag(hash);
+    memcpy((u8 *)map->entries + index * entry_byte_size, old_entry, entry_byte_size);
+  }
+  map->occupied = previous_occupied;
+  allocator_deallocate(
+    map->allocator, previous_control, hash_map_storage_byte_size(previous_capacity, entry_byte_size)
+  );
+}
+
+static inline void
+hash_map_grow_for_insert(
+  Hash_Map_Internal *map,
+  u64 entry_byte_size
+) {
+  // Only grow when live entries take up a significant part of the table,
+  // otherwise the load is mostly tombstones and rehashing in place reclaims them
+  u64 capacity_power_of_2 = map->capacity_power_of_2;
+  if (map->occupied + 1 > map->capacity / 2) capacity_power_of_2 += 1;
+  hash_map_rehash(map, entry_byte_size, capacity_power_of_2);
+}
+
+static void
+hash_map_shrink_to_fit_internal(
+  Hash_Map_Internal *map,
+  u64 entry_byte_size
+) {
+  u64 capacity_power_of_2 = 4;
+  while (map->occupied > hash_map_max_load(1llu << capacity_power_of_2)) {
+    capacity_power_of_2 += 1;
+  }
+  if (capacity_power_of_2 == map->capacity_power_of_2 && !map->tombstones) return;
+  hash_map_rehash(map, entry_byte_size, capacity_power_of_2);
+}
+
+// Returns the first occupied entry at `index` or after it, or 0 if there are none.
+// Whole groups of empty and deleted slots are skipped with a single control byte match.
+static inline void *
+hash_map_entry_at_or_after_internal(
+  const Hash_Map_Internal *map,
+  u64 entry_byte_size,
+  u64 index
+) {
+  while (index < map->capacity) {
+    u64 group_start = index & ~(u64)(HASH_MAP_GROUP_WIDTH - 1);
+    u32 mask = ~hash_map_group_match_empty_or_deleted(map->control + group_start) & 0xffff;
+    mask &= 0xffffu << (index - group_start);
+    if (mask) {
+      return (u8 *)map->entries + (group_start + u32_count_trailing_zeros(mask)) * entry_byte_size;
     }
+    index = group_start + HASH_MAP_GROUP_WIDTH;
   }
-  allocator_deallocate(map->allocator, entries, previous_byte_size);
+  return 0;
 }
 
 struct Hash_Map_Make_Options {
@@ -3974,6 +4474,8 @@ struct Hash_Map_Make_Options {
   u64 initial_capacity;
 };
 
+// `_by_hash` variants must be given the same hash that `_key_hash_fn_`
+// produces for the key since the map rehashes keys when it grows.
 #define hash_map_template(_hash_map_type_, _key_type_, _value_type_, _key_hash_fn_, _key_equality_fn_)\
   hash_map_type_internal(_hash_map_type_, _key_type_, _value_type_)\
   \
@@ -3984,25 +4486,18 @@ struct Hash_Map_Make_Options {
     struct Hash_Map_Make_Options *options\
   ) {\
     _hash_map_type_ *map = allocator_allocate(options->allocator, _hash_map_type_);\
-    u32 capacity_power_of_2 = 1;\
-    u64 capacity = 2;\
+    u64 capacity_power_of_2 = 4;\
+    u64 capacity = 1llu << capacity_power_of_2;\
+    static_assert(HASH_MAP_GROUP_WIDTH == 16, "Minimum capacity must be a whole group");\
     while(capacity < options->initial_capacity) {\
       capacity_power_of_2 += 1;\
       capacity = capacity << 1;\
     }\
-    u64 entry_byte_size = sizeof(map->entries[0]);\
-    u64 entry_array_byte_size = entry_byte_size * capacity;\
-    assert(capacity);\
     *map = (_hash_map_type_) {\
       .methods = _hash_map_type_##__methods,\
       .allocator = options->allocator,\
-      .capacity_power_of_2 = capacity_power_of_2,\
-      .capacity = capacity,\
-      .hash_mask = capacity - 1,\
-      .occupied = 0,\
-      .entries = allocator_allocate_bytes(options->allocator, entry_array_byte_size, 16),\
     };\
-    memset(map->entries, 0, entry_array_byte_size);\
+    hash_map_allocate_storage((Hash_Map_Internal *)map, capacity_power_of_2, sizeof(map->entries[0]));\
     return map;\
   }\
   \
@@ -4012,16 +4507,29 @@ struct Hash_Map_Make_Options {
     u64 hash,\
     _key_type_ key\
   ) {\
+    u8 tag = hash_map_hash_tag(hash);\
+    u64 group_index = hash_map_hash_group(hash) & map->group_mask;\
     for (;;) {\
-      u64 hash_index = hash & map->hash_mask;\
-      _hash_map_type_##__Entry *entry = &map->entries[hash_index];\
-      if (!entry->occupied) return 0;\
-      if (!entry->bookkeeping.tombstone && _key_equality_fn_(key, entry->key)) return entry; \
-      hash = hash_u64(hash);\
+      const u8 *group = map->control + group_index * HASH_MAP_GROUP_WIDTH;\
+      _hash_map_type_##__Entry *group_entries = map->entries + group_index * HASH_MAP_GROUP_WIDTH;\
+      for (u32 mask = hash_map_group_match_tag(group, tag); mask; mask &= mask - 1) {\
+        _hash_map_type_##__Entry *entry = &group_entries[u32_count_trailing_zeros(mask)];\
+        if (_key_equality_fn_(key, entry->key)) return entry;\
+      }\
+      /* An empty slot means the key was never pushed further along the probe sequence */\
+      if (hash_map_group_match_empty(group)) return 0;\
+      group_index = (group_index + 1) & map->group_mask;\
     }\
   }\
   static u64(*_hash_map_type_##__hash)(_key_type_ key) = _key_hash_fn_;\
   \
+  static u64\
+  _hash_map_type_##__hash_entry(\
+    const void *entry\
+  ) {\
+    return _key_hash_fn_(((const _hash_map_type_##__Entry *)entry)->key);\
+  }\
+  \
   static inline _value_type_ *\
   _hash_map_type_##__get_by_hash(\
     _hash_map_type_ *map,\
@@ -4048,7 +4556,18 @@ struct Hash_Map_Make_Options {
     _key_type_ key\
   ) {\
     _hash_map_type_##__Entry *entry = _hash_map_type_##__get_by_hash_internal(map, hash, key);\
-    if (entry) entry->bookkeeping.tombstone = true;\
+    if (!entry) return;\
+    u64 index = entry - map->entries;\
+    u8 *group = map->control + (index & ~(u64)(HASH_MAP_GROUP_WIDTH - 1));\
+    /* Lookups stop at a group with an empty slot, so if this group has one already */\
+    /* no probe sequence continues past it and the slot can become empty as well */\
+    if (hash_map_group_match_empty(group)) {\
+      map->control[index] = HASH_MAP_CONTROL_EMPTY;\
+    } else {\
+      map->control[index] = HASH_MAP_CONTROL_DELETED;\
+      map->tombstones += 1;\
+    }\
+    map->occupied -= 1;\
   }\
   \
   static inline void\
@@ -4066,16 +4585,21 @@ struct Hash_Map_Make_Options {
     _key_type_ key,\
     _value_type_ value\
   ) {\
-    u64 entry_size = sizeof(map->entries[0]);\
+    _hash_map_type_##__Entry *existing = _hash_map_type_##__get_by_hash_internal(map, hash, key);\
+    if (existing) {\
+      existing->value = value;\
+      return &existing->value;\
+    }\
     Hash_Map_Internal *internal = (Hash_Map_Internal *)map;\
-    /* Check for 75% occupancy */ \
-    if (++map->occupied > map->capacity - map->capacity / 4) {\
-      hash_map_resize(internal, entry_size);\
+    /* Check for 87.5% occupancy, tombstones count since they lengthen probe sequences */ \
+    if (map->occupied + map->tombstones + 1 > hash_map_max_load(map->capacity)) {\
+      hash_map_grow_for_insert(internal, sizeof(map->entries[0]));\
     }\
-    u64 index = hash_map_get_insert_index_internal(internal, entry_size, hash);\
+    u64 index = hash_map_find_insert_index_internal(internal, hash);\
+    if (map->control[index] == HASH_MAP_CONTROL_DELETED) map->tombstones -= 1;\
+    map->control[index] = hash_map_hash_tag(hash);\
+    map->occupied += 1;\
     map->entries[index] = (_hash_map_type_##__Entry){\
-      .bookkeeping.hash = hash, \
-      .bookkeeping.occupied = true, \
       .key = key, \
       .value = value, \
     };\
@@ -4098,6 +4622,7 @@ struct Hash_Map_Make_Options {
     .get_by_hash = _hash_map_type_##__get_by_hash,\
     .set_by_hash = _hash_map_type_##__set_by_hash,\
     .delete_by_hash = _hash_map_type_##__delete_by_hash,\
+    .hash_entry = _hash_map_type_##__hash_entry,\
   };\
 
 #define hash_map_c_string_template(_hash_map_type_, _value_type_)\
@@ -4121,14 +4646,26 @@ hash_map_destroy_internal(
   Hash_Map_Internal *internal,
   u64 entry_byte_size
 ) {
-  u64 entry_array_byte_size = entry_byte_size * internal->capacity;
-  allocator_deallocate(internal->allocator, internal->entries, entry_array_byte_size);
+  u64 storage_byte_size = hash_map_storage_byte_size(internal->capacity, entry_byte_size);
+  allocator_deallocate(internal->allocator, internal->control, storage_byte_size);
   allocator_deallocate(internal->allocator, internal, sizeof(Hash_Map_Internal));
 }
 
 #define hash_map_destroy(_map_)\
   hash_map_destroy_internal((void *)(_map_), sizeof((_map_)->entries[0]))
 
+#define hash_map_shrink_to_fit(_map_)\
+  hash_map_shrink_to_fit_internal((void *)(_map_), sizeof((_map_)->entries[0]))
+
+#define HASH_MAP_FOREACH(_entry_type_, _it_name_, _map_)\
+  for (\
+    _entry_type_ *_it_name_ = hash_map_entry_at_or_after_internal((void *)(_map_), sizeof(*_it_name_), 0);\
+    _it_name_;\
+    _it_name_ = hash_map_entry_at_or_after_internal(\
+      (void *)(_map_), sizeof(*_it_name_), (_it_name_ - (_map_)->entries) + 1\
+    )\
+  )
+
 #define hash_map_get(_map_, ...)\
   (_map_)->methods->get((_map_), __VA_ARGS__)
 
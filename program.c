@@ -55,7 +55,15 @@ program_init(
   code_address = (void *)(0x30000000000 + MAX_PROGRAM_SIZE * (index++));
   #endif
 
-  virtual_memory_buffer_init_at_address(&program->memory.buffer, MAX_PROGRAM_SIZE, code_address);
+  s64 execution_offset = 0;
+  #if defined(__linux__)
+  execution_offset = posix_program_memory_init_dual_mapped(
+    &program->memory.buffer, MAX_PROGRAM_SIZE, code_address
+  );
+  #endif
+  if (!execution_offset) {
+    virtual_memory_buffer_init_at_address(&program->memory.buffer, MAX_PROGRAM_SIZE, code_address);
+  }
   program->memory.buffer.commit_step_byte_size = 1024 * 1024;
 
   u64 offset_in_memory = 0;
@@ -68,6 +76,7 @@ program_init(
     },
     .base_rva = u64_to_u32(offset_in_memory),
     .permissions = Section_Permissions_Execute,
+    .execution_offset = execution_offset,
   };
   offset_in_memory += program->memory.code.buffer.capacity;
 
@@ -79,6 +88,7 @@ program_init(
     },
     .base_rva = u64_to_u32(offset_in_memory),
     .permissions = Section_Permissions_Read | Section_Permissions_Write,
+    .execution_offset = execution_offset,
   };
   offset_in_memory += program->memory.rw_data.buffer.capacity;
 
@@ -90,7 +100,12 @@ program_init(
     },
     .base_rva = u64_to_u32(offset_in_memory),
     .permissions = Section_Permissions_Read,
+    .execution_offset = execution_offset,
   };
+
+  #if defined(__linux__)
+  if (execution_offset) posix_program_memory_protect_execution_view(&program->memory);
+  #endif
 }
 
 static void
@@ -101,6 +116,11 @@ program_deinit(
     Import_Library *library = dyn_array_get(program->import_libraries, i);
     dyn_array_destroy(library->symbols);
   }
+  #if defined(__linux__)
+  if (program->memory.code.execution_offset) {
+    posix_program_memory_deinit_execution_view(&program->memory);
+  }
+  #endif
   virtual_memory_buffer_deinit(&program->memory.buffer);
   dyn_array_destroy(program->patch_info_array);
   dyn_array_destroy(program->import_libraries);
@@ -294,7 +314,7 @@ program_jit_resolve_relocations(
     void *address_of = rip_value_pointer_from_label(
       relocation->patch_at.Memory.location.Instruction_Pointer_Relative.label
     );
-    void **patch_at = rip_value_pointer_from_label(
+    void **patch_at = rip_value_writable_pointer_from_label(
       relocation->address_of.Memory.location.Instruction_Pointer_Relative.label
     );
     *patch_at = address_of;
@@ -302,11 +322,30 @@ program_jit_resolve_relocations(
   jit->previous_counts.relocations = relocation_count;
 }
 
+static inline bool
+program_jit_has_pending_changes(
+  const Jit *jit
+) {
+  const Program *program = jit->program;
+  if (dyn_array_length(program->functions) != jit->previous_counts.functions) return true;
+  if (dyn_array_length(program->import_libraries) != jit->previous_counts.imports) return true;
+  if (dyn_array_length(program->relocations) != jit->previous_counts.relocations) return true;
+  return dyn_array_length(program->patch_info_array) != 0;
+}
+
+// Functions are only pushed into the program as they are compiled. Encoding them and
+// fixing up the memory is deferred until a pointer into the jitted code is needed, so
+// callers are expected to only call this right before they need one.
 static void
 program_jit(
   Mass_Context *context,
   Jit *jit
 ) {
+  if (!program_jit_has_pending_changes(jit)) {
+    context->compilation->counters.jit_skipped_commit_count += 1;
+    return;
+  }
+  context->compilation->counters.jit_commit_count += 1;
   Temp_Mark mark = context_temp_mark(context);
   #if defined(_WIN32)
   win32_program_jit(context->compilation, jit);
@@ -317,3 +356,68 @@ program_jit(
   #endif
   context_temp_reset_to_mark(context, mark);
 }
+
+// :ReclaimableJitThunk
+// One-shot thunks, like the ones generated for compile-time evaluation, are only called
+// once so their code and the instructions it was encoded from can be dropped right after.
+// This requires the code section to be dual-mapped, otherwise the pages at the end
+// of the section might have already been switched to be executable.
+static inline bool
+jit_can_reclaim_thunks(
+  const Jit *jit
+) {
+  return jit->program->memory.code.execution_offset != 0;
+}
+
+// Rewinds the code section to the start of the thunk if it is still the last thing
+// that was encoded. Returns the number of reclaimed bytes.
+static u64
+jit_reclaim_thunk(
+  Jit *jit,
+  const Label *start_label,
+  u64 code_occupied_after_jit
+) {
+  Program *program = jit->program;
+  Virtual_Memory_Buffer *code_buffer = &program->memory.code.buffer;
+  Function_Builder *last_builder = dyn_array_last(program->functions);
+  bool is_last = (
+    last_builder &&
+    last_builder->code_block.start_label == start_label &&
+    jit->previous_counts.functions == dyn_array_length(program->functions) &&
+    code_buffer->occupied == code_occupied_after_jit &&
+    dyn_array_length(program->patch_info_array) == 0
+  );
+  if (!is_last) {
+    // Something was compiled while the thunk was running, so the instructions
+    // of the thunk need to stay around together with its builder
+    jit->thunk_buffer_floor = jit->thunk_buffer.occupied;
+    return 0;
+  }
+  assert(start_label->resolved);
+  assert(start_label->section == &program->memory.code);
+
+  u64 start = start_label->offset_in_section;
+  u64 reclaimed_byte_size = code_buffer->occupied - start;
+  // Make sure anything that still jumps into the reclaimed code traps
+  memset(code_buffer->memory + start, 0xCC, reclaimed_byte_size);
+  code_buffer->occupied = start;
+
+  dyn_array_pop(program->functions);
+  jit->previous_counts.functions -= 1;
+  return reclaimed_byte_size;
+}
+
+// Releases labels and instructions allocated for thunks after `mark`, unless they
+// belong to a thunk that could not be reclaimed.
+static void
+jit_thunk_buffer_rewind(
+  Jit *jit,
+  u64 mark
+) {
+  Virtual_Memory_Buffer *buffer = &jit->thunk_buffer;
+  u64 occupied = u64_max(mark, jit->thunk_buffer_floor);
+  if (occupied >= buffer->occupied) return;
+  // Allocations rely on fresh virtual memory being zeroed, so keep it that way
+  memset(buffer->memory + occupied, 0, buffer->occupied - occupied);
+  buffer->occupied = occupied;
+}
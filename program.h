@@ -75,6 +75,24 @@ program_jit(
   Jit *jit
 );
 
+static inline bool
+jit_can_reclaim_thunks(
+  const Jit *jit
+);
+
+static u64
+jit_reclaim_thunk(
+  Jit *jit,
+  const Label *start_label,
+  u64 code_occupied_after_jit
+);
+
+static void
+jit_thunk_buffer_rewind(
+  Jit *jit,
+  u64 mark
+);
+
 typedef struct {
   void *(*load_library)(const char *name);
   void *(*load_symbol)(void *handle, const char *name);
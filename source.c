@@ -104,30 +104,150 @@ scope_make_declarative(
     .allocator = allocator,
     .parent = parent,
     .Declarative = {
-      .map = 0,
+      .layout = Declarative_Scope_Layout_Flat,
     }
   };
   return scope;
 }
 
+// Root and module scopes hold many definitions and are looked through by every
+// nested scope so they store entries in a table indexed directly by symbol id
+// for as long as that table stays dense, see `scope_declarative_insert`
+static inline Scope *
+scope_make_declarative_indexed(
+  const Allocator *allocator,
+  const Scope *parent
+) {
+  Scope *scope = scope_make_declarative(allocator, parent);
+  scope->Declarative.layout = Declarative_Scope_Layout_Direct;
+  return scope;
+}
+
+#define IMPERATIVE_SCOPE_CHUNK_INITIAL_CAPACITY 8
+#define IMPERATIVE_SCOPE_CHUNK_MAX_CAPACITY 256
+
+static Imperative_Scope_Chunk *
+imperative_scope_chunk_make(
+  const Allocator *allocator,
+  u32 capacity
+) {
+  u32 index_capacity = capacity * 2;
+  Imperative_Scope_Chunk *chunk = allocator_allocate(allocator, Imperative_Scope_Chunk);
+  // Entries, shadow links and the index share one allocation
+  Scope_Entry *entries = allocator_allocate_bytes(
+    allocator,
+    capacity * sizeof(Scope_Entry) + (capacity + index_capacity) * sizeof(u16),
+    _Alignof(Scope_Entry)
+  );
+  u16 *shadowed = (u16 *)(entries + capacity);
+  u16 *index = shadowed + capacity;
+  memset(index, 0, index_capacity * sizeof(u16));
+  *chunk = (Imperative_Scope_Chunk) {
+    .capacity = capacity,
+    .index_mask = index_capacity - 1,
+    .entries = entries,
+    .shadowed = shadowed,
+    .index = index,
+  };
+  return chunk;
+}
+
+static inline u16 *
+imperative_scope_chunk_index_slot(
+  const Imperative_Scope_Chunk *chunk,
+  const Symbol *symbol
+) {
+  // Index is at most half full so there is always an empty slot to stop at
+  for (u64 slot = hash_pointer(symbol);; slot += 1) {
+    u16 *it = &chunk->index[slot & chunk->index_mask];
+    if (!*it || chunk->entries[*it - 1].symbol == symbol) return it;
+  }
+}
+
+// :ScopeForEachDeclaration
+// Every local variable gets its own scope so that code can only see the locals defined
+// before it. To avoid walking a parent link per local, a scope made on top of the latest
+// imperative scope appends its entry into the parent's chunk and only remembers how many
+// of the chunk's entries are visible to it. Scopes that branch off an older snapshot
+// or outgrow the chunk start a fresh one.
 static inline Scope *
 scope_make_imperative(
   const Allocator *allocator,
   const Scope *parent,
   const Scope_Entry *scope_entry
 ) {
+  assert(scope_entry->symbol);
+  Imperative_Scope_Chunk *chunk = 0;
+  u32 next_capacity = IMPERATIVE_SCOPE_CHUNK_INITIAL_CAPACITY;
+  if (parent && parent->tag == Scope_Tag_Imperative && parent->allocator == allocator) {
+    Imperative_Scope_Chunk *parent_chunk = parent->Imperative.chunk;
+    if (parent_chunk->count == parent->Imperative.count) {
+      if (parent_chunk->count < parent_chunk->capacity) {
+        chunk = parent_chunk;
+        parent = parent->parent;
+      } else {
+        next_capacity = u32_min(parent_chunk->capacity * 2, IMPERATIVE_SCOPE_CHUNK_MAX_CAPACITY);
+      }
+    }
+  }
+  if (!chunk) chunk = imperative_scope_chunk_make(allocator, next_capacity);
+
+  u32 entry_index = chunk->count;
+  chunk->entries[entry_index] = *scope_entry;
+  u16 *slot = imperative_scope_chunk_index_slot(chunk, scope_entry->symbol);
+  chunk->shadowed[entry_index] = *slot;
+  *slot = (u16)(entry_index + 1);
+  chunk->count = entry_index + 1;
+
   Scope *scope = allocator_allocate(allocator, Scope);
   *scope = (Scope) {
     .tag = Scope_Tag_Imperative,
     .allocator = allocator,
     .parent = parent,
     .Imperative = {
-      .entry = *scope_entry,
+      .chunk = chunk,
+      .count = chunk->count,
     }
   };
   return scope;
 }
 
+// Iterates entries of a declarative scope in no particular order.
+// `cursor` must start at 0 and is advanced past the returned entry.
+static Scope_Entry *
+scope_declarative_next_entry(
+  const Scope *scope,
+  u64 *cursor
+) {
+  assert(scope->tag == Scope_Tag_Declarative);
+  switch (scope->Declarative.layout) {
+    case Declarative_Scope_Layout_Flat: {
+      if (*cursor >= scope->Declarative.count) return 0;
+      return scope->Declarative.entries[(*cursor)++];
+    }
+    case Declarative_Scope_Layout_Direct: {
+      for (; *cursor < scope->Declarative.capacity; *cursor += 1) {
+        Scope_Entry *entry = scope->Declarative.entries[*cursor];
+        if (entry) {
+          *cursor += 1;
+          return entry;
+        }
+      }
+      return 0;
+    }
+    case Declarative_Scope_Layout_Map: {
+      const Scope_Map *map = scope->Declarative.map;
+      Scope_Map__Entry *map_entry =
+        hash_map_entry_at_or_after_internal((void *)map, sizeof(map->entries[0]), *cursor);
+      if (!map_entry) return 0;
+      *cursor = (map_entry - map->entries) + 1;
+      return map_entry->value;
+    }
+  }
+  panic("UNREACHABLE");
+  return 0;
+}
+
 static void
 mass_copy_scope_exports(
   Scope *to,
@@ -135,12 +255,9 @@ mass_copy_scope_exports(
 ) {
   assert(to->tag == Scope_Tag_Declarative);
   assert(from->tag == Scope_Tag_Declarative);
-  for (u64 i = 0; i < from->Declarative.map->capacity; ++i) {
-    Scope_Map__Entry *map_entry = &from->Declarative.map->entries[i];
-    if (!map_entry->occupied) continue;
-    Scope_Entry *entry = map_entry->value;
-    const Symbol *symbol = map_entry->key;
-    scope_define_value(to, entry->epoch, entry->source_range, symbol, entry->value);
+  u64 cursor = 0;
+  for (Scope_Entry *entry; (entry = scope_declarative_next_entry(from, &cursor));) {
+    scope_define_value(to, entry->epoch, entry->source_range, entry->symbol, entry->value);
   }
 }
 
@@ -152,20 +269,16 @@ scope_print_names(
   for (; scope; scope = scope->parent) {
     switch (scope->tag) {
       case Scope_Tag_Imperative: {
-        const Scope_Entry *entry = &scope->Imperative.entry;
-        slice_print(entry->name);
-        printf(" ; ");
+        for (u32 i = scope->Imperative.count; i > 0; --i) {
+          slice_print(scope->Imperative.chunk->entries[i - 1].name);
+          printf(" ; ");
+        }
       } break;
       case Scope_Tag_Declarative: {
-        Scope_Map *map = scope->Declarative.map;
-        if (map) {
-          for (u64 i = 0; i < map->capacity; ++i) {
-            Scope_Map__Entry *entry = &map->entries[i];
-            if (entry->occupied) {
-              slice_print(entry->value->name);
-              printf(" ; ");
-            }
-          }
+        u64 cursor = 0;
+        for (Scope_Entry *entry; (entry = scope_declarative_next_entry(scope, &cursor));) {
+          slice_print(entry->name);
+          printf(" ; ");
         }
         if (flags & Scope_Print_Flags_Stop_At_First_Declarative) goto end;
       } break;
@@ -182,16 +295,30 @@ scope_lookup_shallow(
 ) {
   switch (scope->tag) {
     case Scope_Tag_Imperative: {
-      // TODO avoid cast
-      Scope_Entry *entry = (Scope_Entry *)&scope->Imperative.entry;
-      // TODO use symbols here?
-      if (slice_equal(entry->name, symbol->name)) return entry;
+      const Imperative_Scope_Chunk *chunk = scope->Imperative.chunk;
+      // Skip over entries that were appended to the chunk after this scope was made
+      u32 visible_count = scope->Imperative.count;
+      for (u32 index = *imperative_scope_chunk_index_slot(chunk, symbol); index;) {
+        if (index <= visible_count) return &chunk->entries[index - 1];
+        index = chunk->shadowed[index - 1];
+      }
     } break;
     case Scope_Tag_Declarative: {
-      Scope_Map *map = scope->Declarative.map;
-      if (!map) return 0;
-      Scope_Entry **entry_pointer = hash_map_get(map, symbol);
-      if (entry_pointer) return *entry_pointer;
+      u32 id = symbol_interned(symbol)->id;
+      switch (scope->Declarative.layout) {
+        case Declarative_Scope_Layout_Flat: {
+          for (u32 i = 0; i < scope->Declarative.count; ++i) {
+            if (scope->Declarative.flat_ids[i] == id) return scope->Declarative.entries[i];
+          }
+        } break;
+        case Declarative_Scope_Layout_Direct: {
+          if (id < scope->Declarative.capacity) return scope->Declarative.entries[id];
+        } break;
+        case Declarative_Scope_Layout_Map: {
+          Scope_Entry **entry_pointer = hash_map_get(scope->Declarative.map, symbol);
+          if (entry_pointer) return *entry_pointer;
+        } break;
+      }
     } break;
   }
   return 0;
@@ -209,6 +336,74 @@ scope_lookup(
   return 0;
 }
 
+static inline bool
+mass_scope_is_lookup_cacheable(
+  const Compilation *compilation,
+  const Scope *scope
+) {
+  // Temp arena addresses get reused after a reset so only permanent scopes are cached
+  const Virtual_Memory_Buffer *permanent = &compilation->allocation_buffer;
+  const s8 *address = (const s8 *)scope;
+  return address >= permanent->memory && address < permanent->memory + permanent->occupied;
+}
+
+static inline Scope_Lookup_Cache_Entry *
+mass_scope_lookup_cache_slot(
+  Compilation *compilation,
+  const Scope *scope,
+  const Symbol *symbol
+) {
+  u64 hash = hash_u64((u64)(uintptr_t)scope ^ ((u64)(uintptr_t)symbol << 16));
+  return &compilation->scope_lookup_cache[hash & (SCOPE_LOOKUP_CACHE_SIZE - 1)];
+}
+
+// Remembers where a symbol resolved from a particular scope. A cached result stays
+// valid until a new entry for the symbol is defined anywhere, which is conservative
+// but keeps validation to a single compare. Since most lookups start from a freshly
+// made scope, the walk also checks the cache for each parent it passes through.
+static Scope_Entry *
+mass_scope_lookup_cached(
+  Compilation *compilation,
+  const Scope *scope,
+  const Symbol *symbol
+) {
+  Scope_Entry *entry = 0;
+  bool hit = false;
+  for (const Scope *it = scope; it; it = it->parent) {
+    if (!mass_scope_is_lookup_cacheable(compilation, it)) {
+      entry = scope_lookup_shallow(it, symbol);
+      if (entry) break;
+      continue;
+    }
+    Scope_Lookup_Cache_Entry *slot = mass_scope_lookup_cache_slot(compilation, it, symbol);
+    if (
+      slot->scope == it &&
+      slot->symbol == symbol &&
+      slot->definition_count == symbol_interned(symbol)->definition_count
+    ) {
+      entry = slot->entry;
+      hit = true;
+      break;
+    }
+    entry = scope_lookup_shallow(it, symbol);
+    if (entry) break;
+  }
+  if (hit) {
+    compilation->counters.scope_lookup_cache_hits += 1;
+  } else {
+    compilation->counters.scope_lookup_cache_misses += 1;
+  }
+  if (mass_scope_is_lookup_cacheable(compilation, scope)) {
+    *mass_scope_lookup_cache_slot(compilation, scope, symbol) = (Scope_Lookup_Cache_Entry) {
+      .scope = scope,
+      .symbol = symbol,
+      .entry = entry,
+      .definition_count = symbol_interned(symbol)->definition_count,
+    };
+  }
+  return entry;
+}
+
 static Value *
 token_value_force_immediate_integer(
   Mass_Context *context,
@@ -323,7 +518,7 @@ assign_from_static(
     const Descriptor *pointee_descriptor = source->descriptor->Pointer_To.descriptor;
     if (maybe_custom_array_length) {
       pointee_descriptor = descriptor_array_of(
-        context->allocator, pointee_descriptor, *maybe_custom_array_length
+        context->compilation, pointee_descriptor, *maybe_custom_array_length
       );
     }
     Bits bit_size = pointee_descriptor->bit_size;
@@ -369,7 +564,7 @@ assign_from_static(
     }
     return true;
   } else if (storage_is_label(target_storage)) {
-    void *section_memory = rip_value_pointer_from_storage(target_storage);
+    void *section_memory = rip_value_writable_pointer_from_storage(target_storage);
     const void *source_memory =
       storage_static_memory_with_bit_size(source_storage, source_storage->bit_size);
     // TODO the actual copying probably should be deferred till we are ready to write out code
@@ -464,14 +659,56 @@ c_struct_aligner_end(
   }
 }
 
+// Structs with fewer fields are faster to scan than to hash the name for
+#define STRUCT_FIELD_INDEX_MIN_FIELD_COUNT 16
+
+// :StructFieldIndex
+// The index is keyed by the descriptor address so descriptors in the temp arena
+// are not indexed as the address might be reused for a different struct later
+static Struct_Field_Name_Map *
+struct_field_name_index(
+  Compilation *compilation,
+  const Descriptor *descriptor
+) {
+  Array_Struct_Field fields = descriptor->Struct.fields;
+  if (dyn_array_length(fields) < STRUCT_FIELD_INDEX_MIN_FIELD_COUNT) return 0;
+  if (mass_is_temp_address(compilation, descriptor)) return 0;
+  Struct_Field_Name_Map **maybe_index = hash_map_get(compilation->struct_field_index_map, descriptor);
+  if (maybe_index) return *maybe_index;
+
+  Struct_Field_Name_Map *index = hash_map_make(
+    Struct_Field_Name_Map,
+    .allocator = compilation->allocator,
+    .initial_capacity = dyn_array_length(fields) * 2,
+  );
+  for (u64 i = 0; i < dyn_array_length(fields); ++i) {
+    const Struct_Field *field = dyn_array_get(fields, i);
+    // Unnamed fields are only accessible by position and the first field wins for duplicates
+    if (!field->name.length || hash_map_has(index, field->name)) continue;
+    hash_map_set(index, field->name, i);
+  }
+  hash_map_set(compilation->struct_field_index_map, descriptor, index);
+  return index;
+}
+
 static inline bool
 struct_find_field_by_name(
+  Compilation *compilation,
   const Descriptor *descriptor,
   Slice field_name,
   const Struct_Field **out_field,
   u64 *out_index
 ) {
   assert(descriptor->tag == Descriptor_Tag_Struct);
+  Struct_Field_Name_Map *index = struct_field_name_index(compilation, descriptor);
+  if (index) {
+    if (!field_name.length) return false;
+    u64 *maybe_field_index = hash_map_get(index, field_name);
+    if (!maybe_field_index) return false;
+    *out_field = dyn_array_get(descriptor->Struct.fields, *maybe_field_index);
+    *out_index = *maybe_field_index;
+    return true;
+  }
   for(u64 i = 0; i < dyn_array_length(descriptor->Struct.fields); ++i) {
     const Struct_Field *field = dyn_array_get(descriptor->Struct.fields, i);
     if (slice_equal(field->name, field_name)) {
@@ -503,19 +740,20 @@ typedef enum {
   Tuple_Eval_Mode_Type,
 } Tuple_Eval_Mode;
 
-static Descriptor *
+static const Descriptor *
 anonymous_struct_descriptor_from_tuple(
   Mass_Context *context,
   const Tuple *tuple,
   Tuple_Eval_Mode tuple_eval_mode
 ) {
-  Descriptor *tuple_descriptor = 0;
+  const Descriptor *tuple_descriptor = 0;
   Temp_Mark temp_mark = context_temp_mark(context);
 
   C_Struct_Aligner struct_aligner = {0};
+  // Fields are only collected here, the interner makes a permanent copy for a new shape
   Array_Struct_Field fields = dyn_array_make(
     Array_Struct_Field,
-    .allocator = context->allocator,
+    .allocator = context->temp_allocator,
     .capacity = dyn_array_length(tuple->items),
   );
 
@@ -593,8 +831,7 @@ anonymous_struct_descriptor_from_tuple(
   }
   c_struct_aligner_end(&struct_aligner);
 
-  tuple_descriptor = mass_allocate(context, Descriptor);
-  *tuple_descriptor = (Descriptor) {
+  Descriptor candidate = {
     .tag = Descriptor_Tag_Struct,
     .bit_size = {struct_aligner.bit_size},
     .bit_alignment = {struct_aligner.bit_alignment},
@@ -602,6 +839,22 @@ anonymous_struct_descriptor_from_tuple(
       .fields = fields,
     },
   };
+  // Tuples of the same shape share a descriptor, so forcing them repeatedly does not allocate
+  tuple_descriptor = descriptor_intern(context->compilation, &candidate);
+  if (tuple_descriptor == &candidate) {
+    // Field types that live in the temp arena can not be interned
+    Descriptor *copy = mass_allocate(context, Descriptor);
+    *copy = candidate;
+    copy->Struct.fields = dyn_array_make(
+      Array_Struct_Field,
+      .allocator = context->allocator,
+      .capacity = dyn_array_length(fields),
+    );
+    DYN_ARRAY_FOREACH(Struct_Field, field, fields) {
+      dyn_array_push(copy->Struct.fields, *field);
+    }
+    tuple_descriptor = copy;
+  }
 
   err:
   context_temp_reset_to_mark(context, temp_mark);
@@ -668,7 +921,7 @@ mass_process_tuple_as_descriptor(
           goto err;
         }
         field_source = scope_entry_force_value(context, entry);
-        if (!struct_find_field_by_name(descriptor, symbol->name, &field, &field_index)) {
+        if (!struct_find_field_by_name(context->compilation, descriptor, symbol->name, &field, &field_index)) {
           report_error_proc(context, (Mass_Error) {
             .tag = Mass_Error_Tag_Unknown_Field,
             .source_range = tuple_item->source_range,
@@ -683,7 +936,7 @@ mass_process_tuple_as_descriptor(
           goto err;
         }
         const Named_Accessor *accessor = value_as_named_accessor(assignment->target);
-        if (!struct_find_field_by_name(descriptor, accessor->symbol->name, &field, &field_index)) {
+        if (!struct_find_field_by_name(context->compilation, descriptor, accessor->symbol->name, &field, &field_index)) {
           report_error_proc(context, (Mass_Error) {
             .tag = Mass_Error_Tag_Unknown_Field,
             .source_range = tuple_item->source_range,
@@ -1287,8 +1540,9 @@ scope_maybe_force_overload(
 ) {
   if (value_is_overload(value)) {
     const Overload *overload = value_as_overload(value);
-    scope_maybe_force_overload(context, overload->value, name);
-    scope_maybe_force_overload(context, overload->next, name);
+    for (u64 i = 0; i < dyn_array_length(overload->values); ++i) {
+      scope_maybe_force_overload(context, *dyn_array_get(overload->values, i), name);
+    }
     return;
   }
   if (mass_has_error(context)) return;
@@ -1344,7 +1598,7 @@ mass_context_force_lookup(
   const Symbol *symbol,
   const Source_Range *lookup_range
 ) {
-  Scope_Entry *entry = scope_lookup(scope, symbol);
+  Scope_Entry *entry = mass_scope_lookup_cached(context->compilation, scope, symbol);
 
   if (!entry) {
     mass_error(context, (Mass_Error) {
@@ -1376,6 +1630,94 @@ scope_find_nearest_declarative(
   return scope;
 }
 
+#define SCOPE_FLAT_INITIAL_CAPACITY 4
+#define SCOPE_FLAT_MAX_CAPACITY 16
+
+// Direct tables are sized by the largest symbol id, so a module scope that mostly defines
+// symbols interned late in the compilation switches to a map instead of staying sparse
+#define SCOPE_DIRECT_INITIAL_CAPACITY 256
+#define SCOPE_DIRECT_MAX_SPARSITY 4
+
+static void
+scope_declarative_switch_to_map(
+  Scope *scope
+) {
+  assert(scope->Declarative.layout != Declarative_Scope_Layout_Map);
+  u32 count = scope->Declarative.count;
+  Scope_Map *map = hash_map_make(Scope_Map, scope->allocator, .initial_capacity = count * 2);
+  u64 cursor = 0;
+  for (Scope_Entry *existing; (existing = scope_declarative_next_entry(scope, &cursor));) {
+    hash_map_set(map, existing->symbol, existing);
+  }
+  scope->Declarative.layout = Declarative_Scope_Layout_Map;
+  scope->Declarative.map = map;
+}
+
+static void
+scope_declarative_insert(
+  Scope *scope,
+  const Symbol *symbol,
+  Scope_Entry *entry
+) {
+  const Allocator *allocator = scope->allocator;
+  u32 id = symbol_interned(symbol)->id;
+  switch (scope->Declarative.layout) {
+    case Declarative_Scope_Layout_Flat: {
+      u32 count = scope->Declarative.count;
+      if (count == scope->Declarative.capacity) {
+        if (count == SCOPE_FLAT_MAX_CAPACITY) {
+          scope_declarative_switch_to_map(scope);
+          scope_declarative_insert(scope, symbol, entry);
+          return;
+        }
+        u32 capacity = count ? count * 2 : SCOPE_FLAT_INITIAL_CAPACITY;
+        // Entries and ids share an allocation with the 8-byte aligned entries first
+        Scope_Entry **entries = allocator_allocate_bytes(
+          allocator, capacity * (sizeof(Scope_Entry *) + sizeof(u32)), _Alignof(Scope_Entry *)
+        );
+        u32 *flat_ids = (u32 *)(entries + capacity);
+        if (count) {
+          memcpy(entries, scope->Declarative.entries, count * sizeof(Scope_Entry *));
+          memcpy(flat_ids, scope->Declarative.flat_ids, count * sizeof(u32));
+        }
+        scope->Declarative.entries = entries;
+        scope->Declarative.flat_ids = flat_ids;
+        scope->Declarative.capacity = capacity;
+      }
+      scope->Declarative.entries[count] = entry;
+      scope->Declarative.flat_ids[count] = id;
+      scope->Declarative.count = count + 1;
+    } break;
+    case Declarative_Scope_Layout_Direct: {
+      u32 capacity = scope->Declarative.capacity;
+      if (id >= capacity) {
+        u32 new_capacity = capacity ? capacity : SCOPE_DIRECT_INITIAL_CAPACITY;
+        while (new_capacity <= id) new_capacity *= 2;
+        u32 dense_capacity = (scope->Declarative.count + 1) * SCOPE_DIRECT_MAX_SPARSITY;
+        // There is only one root scope and every lookup that misses ends up there
+        // so it keeps the direct table no matter how sparse it gets
+        bool is_root = !scope->parent;
+        if (!is_root && id >= u32_max(dense_capacity, SCOPE_DIRECT_INITIAL_CAPACITY)) {
+          scope_declarative_switch_to_map(scope);
+          scope_declarative_insert(scope, symbol, entry);
+          return;
+        }
+        Scope_Entry **entries = allocator_allocate_array(allocator, Scope_Entry *, new_capacity);
+        if (capacity) memcpy(entries, scope->Declarative.entries, capacity * sizeof(Scope_Entry *));
+        memset(entries + capacity, 0, (new_capacity - capacity) * sizeof(Scope_Entry *));
+        scope->Declarative.entries = entries;
+        scope->Declarative.capacity = new_capacity;
+      }
+      scope->Declarative.entries[id] = entry;
+      scope->Declarative.count += 1;
+    } break;
+    case Declarative_Scope_Layout_Map: {
+      hash_map_set(scope->Declarative.map, symbol, entry);
+      scope->Declarative.count += 1;
+    } break;
+  }
+}
+
 // TODO rename to `scope_define_declarative`
 static inline void
 scope_define_value(
@@ -1386,13 +1728,23 @@ scope_define_value(
   Value *value
 ) {
   scope = scope_find_nearest_declarative(scope);
-  if (!scope->Declarative.map) {
-    scope->Declarative.map = hash_map_make(Scope_Map, scope->allocator);
-  }
   Scope_Entry *it = scope_lookup_shallow(scope, symbol);
   if (it) {
+    // Sets are never modified in place, see `mass_match_overload`
+    const Overload *previous = value_is_overload(it->value) ? value_as_overload(it->value) : 0;
+    u64 previous_count = previous ? dyn_array_length(previous->values) : 1;
     Overload *overload = allocator_allocate(scope->allocator, Overload);
-    *overload = (Overload) { .value = value, .next = it->value };
+    *overload = (Overload) {
+      .values = dyn_array_make(Array_Value_Ptr, .allocator = scope->allocator, .capacity = previous_count + 1),
+    };
+    dyn_array_push(overload->values, value);
+    if (previous) {
+      for (u64 i = 0; i < dyn_array_length(previous->values); ++i) {
+        dyn_array_push(overload->values, *dyn_array_get(previous->values, i));
+      }
+    } else {
+      dyn_array_push(overload->values, it->value);
+    }
     it->value = value_init(
       allocator_allocate(scope->allocator, Value),
       &descriptor_overload, storage_static(overload), source_range
@@ -1401,11 +1753,13 @@ scope_define_value(
     Scope_Entry *allocated = allocator_allocate(scope->allocator, Scope_Entry);
     *allocated = (Scope_Entry) {
       .value = value,
+      .symbol = symbol,
       .name = symbol->name,
       .epoch = epoch,
       .source_range = source_range,
     };
-    hash_map_set(scope->Declarative.map, symbol, allocated);
+    scope_declarative_insert(scope, symbol, allocated);
+    symbol_interned(symbol)->definition_count += 1;
   }
 }
 
@@ -1426,10 +1780,13 @@ scope_define_operator(
     if (maybe_operator_symbol) {
       operator_symbol = *maybe_operator_symbol;
     } else {
-      Symbol *new_symbol = mass_allocate(context, Symbol);
-      *new_symbol = *base_symbol;
-      hash_map_set(map, base_symbol, new_symbol);
-      operator_symbol = new_symbol;
+      Interned_Symbol *new_symbol = mass_allocate(context, Interned_Symbol);
+      *new_symbol = (Interned_Symbol) {
+        .symbol = { .name = base_symbol->name },
+        .id = mass_next_symbol_id(context->compilation),
+      };
+      hash_map_set(map, base_symbol, &new_symbol->symbol);
+      operator_symbol = &new_symbol->symbol;
     }
   }
 
@@ -1447,6 +1804,7 @@ scope_define_operator(
 
   Value *operator_value = value_make(context, &descriptor_operator, storage_static(operator), source_range);
   scope_define_value(scope, VALUE_STATIC_EPOCH, source_range, operator_symbol, operator_value);
+  symbol_interned(base_symbol)->operator_fixities |= operator->fixity;
 }
 
 static inline const Operator *
@@ -1456,6 +1814,12 @@ scope_lookup_operator(
   const Symbol *base_symbol,
   Operator_Fixity fixity
 ) {
+  // Most symbols are never declared as operators so they can be rejected without any lookups
+  u32 map_fixities = fixity == Operator_Fixity_Prefix
+    ? Operator_Fixity_Prefix
+    : Operator_Fixity_Infix | Operator_Fixity_Postfix;
+  if (!(symbol_interned(base_symbol)->operator_fixities & map_fixities)) return 0;
+
   Operator_Symbol_Map *map = fixity == Operator_Fixity_Prefix
     ? context->compilation->prefix_operator_symbol_map
     : context->compilation->infix_or_suffix_operator_symbol_map;
@@ -1463,7 +1827,8 @@ scope_lookup_operator(
   const Symbol **operator_symbol_pointer = hash_map_get(map, base_symbol);
   if (!operator_symbol_pointer) return 0;
   const Symbol *operator_symbol = *operator_symbol_pointer;
-  Scope_Entry *maybe_operator_entry = scope_lookup(scope, operator_symbol);
+  Scope_Entry *maybe_operator_entry =
+    mass_scope_lookup_cached(context->compilation, scope, operator_symbol);
   if (!maybe_operator_entry) return 0;
   if (maybe_operator_entry->value->descriptor != &descriptor_operator) return 0;
   return value_as_operator(maybe_operator_entry->value);
@@ -2275,7 +2640,7 @@ mass_import(
       module = *module_pointer;
     } else {
       const Scope *root_scope = context->compilation->root_scope;
-      Scope *module_scope = scope_make_declarative(context->allocator, root_scope);
+      Scope *module_scope = scope_make_declarative_indexed(context->allocator, root_scope);
       module = program_module_from_file(context, file_path, module_scope);
       program_import_module(context, module);
       if (mass_has_error(context)) return 0;
@@ -2405,11 +2770,16 @@ mass_c_struct(
   if (!mass_value_ensure_static_of(context, tuple_value, &descriptor_tuple)) return 0;
   const Tuple *tuple = value_as_tuple(tuple_value);
 
-  Descriptor *descriptor = anonymous_struct_descriptor_from_tuple(
+  const Descriptor *anonymous = anonymous_struct_descriptor_from_tuple(
     context, tuple, Tuple_Eval_Mode_Type
   );
   if (mass_has_error(context)) return 0;
-  assert(descriptor->tag == Descriptor_Tag_Struct);
+  assert(anonymous->tag == Descriptor_Tag_Struct);
+
+  // The anonymous descriptor is shared by all tuples of the same shape so branding
+  // needs a copy. Interned fields are never modified so they can be shared.
+  Descriptor *descriptor = mass_allocate(context, Descriptor);
+  *descriptor = *anonymous;
   descriptor->brand = mass_allocate(context, Symbol);
 
   Value *result = mass_allocate(context, Value);
@@ -2445,26 +2815,43 @@ compile_time_eval(
     context->result = eval_context.result;
     return 0;
   }
+  if (expression_result_value->tag == Value_Tag_Lazy) {
+    Value *interpreted = mass_interpret(&eval_context, expression_result_value);
+    if (mass_has_error(&eval_context)) {
+      context->result = eval_context.result;
+      return 0;
+    }
+    if (interpreted) {
+      context->compilation->counters.compile_time_eval_interpreted_count += 1;
+      return interpreted;
+    }
+  }
   const Descriptor *result_descriptor = expression_result_value->descriptor;
 
   static Slice eval_name = slice_literal_fields("$compile_time_eval$");
   Function_Info fn_info;
   function_info_init(&fn_info, result_descriptor);
 
+  // :ReclaimableJitThunk
+  // Labels and instructions of the thunk go into a separate arena that is rewound after the call
+  bool is_reclaimable = jit_can_reclaim_thunks(jit);
+  u64 thunk_mark = jit->thunk_buffer.occupied;
+  const Allocator *thunk_allocator = is_reclaimable ? jit->thunk_allocator : context->allocator;
+
   const Calling_Convention *calling_convention = jit->program->default_calling_convention;
   Section *section = &jit->program->memory.code;
   Label *eval_label = make_label(
-    context->allocator, jit->program, section, slice_literal("compile_time_eval")
+    thunk_allocator, jit->program, section, slice_literal("compile_time_eval")
   );
   Function_Builder eval_builder = {
     .epoch = eval_parser.epoch,
     .function = &fn_info,
     .register_volatile_bitset = calling_convention->register_volatile_bitset,
     .code_block = {
-      .allocator = context->allocator,
+      .allocator = thunk_allocator,
       .start_label = eval_label,
       .end_label = make_label(
-        context->allocator, jit->program, section, slice_literal("compile_time_eval_end")
+        thunk_allocator, jit->program, section, slice_literal("compile_time_eval_end")
       ),
     },
     .source = source_from_source_range(context->compilation, source_range),
@@ -2479,9 +2866,12 @@ compile_time_eval(
   // If we didn't generate any instructions there is no point
   // actually running the code, we can just take the resulting value
   if (!eval_builder.code_block.first_bucket) {
+    if (is_reclaimable) jit_thunk_buffer_rewind(jit, thunk_mark);
     return forced_value;
   }
 
+  context->compilation->counters.compile_time_eval_jit_count += 1;
+
   void *result = mass_allocate_bytes_from_descriptor(context, result_descriptor);
 
   // Load the address of the result
@@ -2507,13 +2897,237 @@ compile_time_eval(
   program_jit(context, jit);
   if (mass_has_error(context)) return 0;
 
+  u64 code_occupied_after_jit = section->buffer.occupied;
   fn_type_opaque jitted_code = (fn_type_opaque)rip_value_pointer_from_label(eval_label);
   jitted_code();
 
+  if (is_reclaimable) {
+    u64 reclaimed_byte_size = jit_reclaim_thunk(jit, eval_label, code_occupied_after_jit);
+    if (reclaimed_byte_size) {
+      context->compilation->counters.jit_reclaimed_thunk_count += 1;
+      context->compilation->counters.jit_reclaimed_thunk_byte_count += reclaimed_byte_size;
+      jit_thunk_buffer_rewind(jit, thunk_mark);
+    }
+  }
+
   Storage result_storage = storage_immediate_with_bit_size(result, result_descriptor->bit_size);
   return value_make(context, out_value->descriptor, result_storage, *source_range);
 }
 
+// Records what a token of a compile-time expression depends on. Returns false if
+// it depends on something that can change between evaluations, such as runtime values.
+static bool
+compile_time_eval_push_input(
+  const Compilation *compilation,
+  const Symbol *symbol,
+  const Value *value,
+  Array_Compile_Time_Eval_Input *inputs
+) {
+  if (!value) {
+    dyn_array_push(*inputs, (Compile_Time_Eval_Input) { .symbol = symbol });
+    return true;
+  }
+  if (mass_is_temp_address(compilation, value->descriptor)) return false;
+  u64 bits;
+  if (value->tag == Value_Tag_Lazy) {
+    // Definitions that were not forced yet are identified by the value itself
+    if (value->descriptor != &descriptor_lazy_static_value) return false;
+    if (mass_is_temp_address(compilation, value)) return false;
+    bits = (u64)(uintptr_t)value;
+  } else if (value->Forced.storage.tag == Storage_Tag_Immediate) {
+    bits = value->Forced.storage.Immediate.bits;
+  } else if (value->Forced.storage.tag == Storage_Tag_Static) {
+    const void *pointer = value->Forced.storage.Static.pointer;
+    if (mass_is_temp_address(compilation, pointer)) return false;
+    bits = (u64)(uintptr_t)pointer;
+  } else {
+    return false;
+  }
+  dyn_array_push(*inputs, (Compile_Time_Eval_Input) {
+    .symbol = symbol,
+    .descriptor = value->descriptor,
+    .bits = bits,
+  });
+  return true;
+}
+
+static bool
+compile_time_eval_collect_inputs(
+  const Compilation *compilation,
+  const Scope *scope,
+  Value_View view,
+  Array_Compile_Time_Eval_Input *inputs
+);
+
+static bool
+compile_time_eval_collect_symbol_input(
+  const Compilation *compilation,
+  const Scope *scope,
+  const Symbol *symbol,
+  Array_Compile_Time_Eval_Input *inputs
+) {
+  // Symbols defined by the expression itself are not in the scope yet,
+  // so the lookup either fails or finds a shadowed outer definition.
+  Scope_Entry *entry = scope_lookup(scope, symbol);
+  return compile_time_eval_push_input(compilation, symbol, entry ? entry->value : 0, inputs);
+}
+
+static bool
+compile_time_eval_collect_inputs(
+  const Compilation *compilation,
+  const Scope *scope,
+  Value_View view,
+  Array_Compile_Time_Eval_Input *inputs
+) {
+  for (u64 i = 0; i < view.length; ++i) {
+    Value *token = value_view_get(&view, i);
+    if (value_is_symbol(token)) {
+      if (!compile_time_eval_collect_symbol_input(compilation, scope, value_as_symbol(token), inputs)) {
+        return false;
+      }
+    } else if (value_is_group_paren(token)) {
+      if (!compile_time_eval_collect_inputs(compilation, scope, value_as_group_paren(token)->children, inputs)) {
+        return false;
+      }
+    } else if (value_is_group_square(token)) {
+      if (!compile_time_eval_collect_inputs(compilation, scope, value_as_group_square(token)->children, inputs)) {
+        return false;
+      }
+    } else if (value_is_ast_block(token)) {
+      const Ast_Block *block = value_as_ast_block(token);
+      const Token_Stream *stream = block->lazy_stream;
+      if (stream) {
+        // Walk the packed tokens instead of forcing the block to be built
+        for (u32 index = block->lazy_from_token; index < block->lazy_to_token; ++index) {
+          if (stream->tags[index] != Tokenizer_Token_Tag_Symbol) continue;
+          const Symbol *symbol = (const Symbol *)(uintptr_t)stream->payloads[index];
+          if (!compile_time_eval_collect_symbol_input(compilation, scope, symbol, inputs)) {
+            return false;
+          }
+        }
+      } else {
+        for (const Ast_Statement *it = block->first_statement; it; it = it->next) {
+          if (!compile_time_eval_collect_inputs(compilation, scope, it->children, inputs)) {
+            return false;
+          }
+        }
+      }
+    } else {
+      // Literals are covered by the source range, but tokens substituted by macros are not
+      if (!compile_time_eval_push_input(compilation, 0, token, inputs)) return false;
+    }
+  }
+  return true;
+}
+
+static u64
+compile_time_eval_cache_hash(
+  const Source_Range *source_range,
+  Array_Compile_Time_Eval_Input inputs
+) {
+  u64 hash = hash_u64((u64)(uintptr_t)source_range->file);
+  hash = hash_u64(hash ^ source_range->offsets.from ^ ((u64)source_range->offsets.to << 32));
+  DYN_ARRAY_FOREACH(Compile_Time_Eval_Input, input, inputs) {
+    hash = hash_u64(hash ^ (u64)(uintptr_t)input->symbol);
+    hash = hash_u64(hash ^ (u64)(uintptr_t)input->descriptor ^ input->bits);
+  }
+  return hash;
+}
+
+static bool
+compile_time_eval_cache_entry_matches(
+  const Compile_Time_Eval_Cache_Entry *entry,
+  const Source_Range *source_range,
+  Array_Compile_Time_Eval_Input inputs
+) {
+  if (entry->source_range.file != source_range->file) return false;
+  if (entry->source_range.offsets.from != source_range->offsets.from) return false;
+  if (entry->source_range.offsets.to != source_range->offsets.to) return false;
+  if (dyn_array_length(entry->inputs) != dyn_array_length(inputs)) return false;
+  for (u64 i = 0; i < dyn_array_length(inputs); ++i) {
+    const Compile_Time_Eval_Input *a = dyn_array_get(entry->inputs, i);
+    const Compile_Time_Eval_Input *b = dyn_array_get(inputs, i);
+    if (a->symbol != b->symbol || a->descriptor != b->descriptor || a->bits != b->bits) return false;
+  }
+  return true;
+}
+
+// Evaluations of the same expression that see the same static values for all of the
+// symbols it references produce the same result, unless the expression has side effects
+// or reads mutable memory at compile time. Such expressions should use `@!` instead of `@`.
+static Value *
+compile_time_eval_memoized(
+  Mass_Context *context,
+  Parser *parser,
+  Value_View view
+) {
+  if (context->result->tag != Mass_Result_Tag_Success) return 0;
+
+  Compilation *compilation = context->compilation;
+  const Source_Range *source_range = &view.source_range;
+  Temp_Mark temp_mark = context_temp_mark(context);
+  Array_Compile_Time_Eval_Input inputs = dyn_array_make(
+    Array_Compile_Time_Eval_Input,
+    .allocator = context->temp_allocator,
+    .capacity = 16,
+  );
+  if (!compile_time_eval_collect_inputs(compilation, parser->scope, view, &inputs)) {
+    context_temp_reset_to_mark(context, temp_mark);
+    return compile_time_eval(context, parser, view);
+  }
+
+  u64 hash = compile_time_eval_cache_hash(source_range, inputs);
+  Compile_Time_Eval_Cache_Entry **maybe_head = hash_map_get(compilation->compile_time_eval_cache_map, hash);
+  Compile_Time_Eval_Cache_Entry *head = maybe_head ? *maybe_head : 0;
+  for (Compile_Time_Eval_Cache_Entry *entry = head; entry; entry = entry->next) {
+    if (!compile_time_eval_cache_entry_matches(entry, source_range, inputs)) continue;
+    context_temp_reset_to_mark(context, temp_mark);
+    compilation->counters.compile_time_eval_cache_hits += 1;
+    Value *result = mass_allocate(context, Value);
+    *result = *entry->result;
+    result->source_range = *source_range;
+    return result;
+  }
+  compilation->counters.compile_time_eval_cache_misses += 1;
+
+  Value *result = compile_time_eval(context, parser, view);
+  if (result && !mass_has_error(context) && result->tag == Value_Tag_Forced) {
+    // The evaluation most likely forced some of the lazy definitions it referenced,
+    // so the inputs are collected again to match what the next lookup will see
+    dyn_array_clear(inputs);
+    if (!compile_time_eval_collect_inputs(compilation, parser->scope, view, &inputs)) goto done;
+    hash = compile_time_eval_cache_hash(source_range, inputs);
+    maybe_head = hash_map_get(compilation->compile_time_eval_cache_map, hash);
+    head = maybe_head ? *maybe_head : 0;
+
+    // Only the value itself is copied, so it must not reference anything temporary
+    if (!compile_time_eval_push_input(compilation, 0, result, &inputs)) goto done;
+    // The result was pushed only to check it, it is not part of the key
+    dyn_array_pop(inputs);
+
+    Value *cached_result = allocator_allocate(compilation->allocator, Value);
+    *cached_result = *result;
+    Compile_Time_Eval_Cache_Entry *entry = allocator_allocate(compilation->allocator, Compile_Time_Eval_Cache_Entry);
+    *entry = (Compile_Time_Eval_Cache_Entry) {
+      .source_range = *source_range,
+      .inputs = dyn_array_make(
+        Array_Compile_Time_Eval_Input,
+        .allocator = compilation->allocator,
+        .capacity = dyn_array_length(inputs),
+      ),
+      .result = cached_result,
+      .next = head,
+    };
+    DYN_ARRAY_FOREACH(Compile_Time_Eval_Input, input, inputs) {
+      dyn_array_push(entry->inputs, *input);
+    }
+    hash_map_set(compilation->compile_time_eval_cache_map, hash, entry);
+  }
+  done:
+  context_temp_reset_to_mark(context, temp_mark);
+  return result;
+}
+
 typedef struct {
   Source_Range source_range;
   const Operator *operator;
@@ -3414,68 +4028,199 @@ mass_match_overload_candidate(
   Array_Overload_Match_State matches
 ) {
   if (mass_has_error(context)) return;
-  if (value_is_overload(candidate)) {
-    const Overload *overload = value_as_overload(candidate);
-    mass_match_overload_candidate(context, overload->value, args, matches);
-    mass_match_overload_candidate(context, overload->next, args, matches);
+  Mass_Argument_Scoring_Flags scoring_flags = 0;
+  const Function_Info *overload_info;
+  if (value_is_function_literal(candidate)) {
+    const Function_Literal *literal = value_as_function_literal(candidate);
+    // :OverloadLock Disallow matching this literal if it was locked for some reason
+    if (*literal->overload_lock_count) {
+      return;
+    }
+    if (literal->header.flags & Function_Header_Flags_Compile_Time) {
+      if (!args->all_arguments_are_compile_time_known) return;
+      scoring_flags |= Mass_Argument_Scoring_Flags_Prefer_Compile_Time;
+    }
+    if (!match_overload_argument_count(literal->header.parameters, dyn_array_length(args->parameters))) {
+      return;
+    }
+    Function_Info *specialized_info;
+    {
+      // :OverloadLock
+      // A literal must be locked here to allow using its overload to be used
+      // inside the function signature. Here's an example:
+      //    pointer_to :: fn(type : Type) => (Type) MASS.pointer_to_type
+      //    pointer_to :: fn(x) -> (pointer_to(x)) MASS.pointer_to
+      // Without the lock the second literal will infinitely recurse
+      *literal->overload_lock_count += 1;
+      context->compilation->overload_lock_depth += 1;
+      specialized_info = function_literal_info_for_parameters(context, literal, args->parameters);
+      context->compilation->overload_lock_depth -= 1;
+      *literal->overload_lock_count -= 1;
+    }
+    overload_info = specialized_info;
+    if (!overload_info) return;
   } else {
-    Mass_Argument_Scoring_Flags scoring_flags = 0;
-    const Function_Info *overload_info;
-    if (value_is_function_literal(candidate)) {
-      const Function_Literal *literal = value_as_function_literal(candidate);
-      // :OverloadLock Disallow matching this literal if it was locked for some reason
-      if (*literal->overload_lock_count) {
-        return;
-      }
-      if (literal->header.flags & Function_Header_Flags_Compile_Time) {
-        if (!args->all_arguments_are_compile_time_known) return;
-        scoring_flags |= Mass_Argument_Scoring_Flags_Prefer_Compile_Time;
-      }
-      if (!match_overload_argument_count(literal->header.parameters, dyn_array_length(args->parameters))) {
-        return;
+    const Descriptor *descriptor = candidate->descriptor;
+    const Descriptor_Function_Instance *instance = descriptor_as_function_instance(descriptor);
+    overload_info = instance->info;
+    if (overload_info->flags & Function_Info_Flags_Compile_Time) {
+      assert(instance->program == context->compilation->jit.program);
+      if (!args->all_arguments_are_compile_time_known) return;
+      scoring_flags |= Mass_Argument_Scoring_Flags_Prefer_Compile_Time;
+    } else {
+      if (instance->program && instance->program != context->program) return;
+    }
+  }
+
+  Overload_Match_Summary summary = calculate_arguments_match_score(
+    context, overload_info, args->parameters, scoring_flags
+  );
+  if (summary.matched) {
+    dyn_array_push(matches, (Overload_Match_State) {
+      .info = overload_info,
+      .value = candidate,
+      .summary = summary,
+    });
+  }
+}
+
+static void
+mass_overload_collect_candidates(
+  const Overload *overload,
+  Array_Overload_Candidate *candidates,
+  Array_Overload_Bucket *ranges
+) {
+  for (u64 value_index = 0; value_index < dyn_array_length(overload->values); ++value_index) {
+    Value *value = *dyn_array_get(overload->values, value_index);
+    // An overload set can also contain another set, i.e. via an alias
+    if (value_is_overload(value)) {
+      mass_overload_collect_candidates(value_as_overload(value), candidates, ranges);
+      continue;
+    }
+    Overload_Candidate candidate = { .value = value };
+    // Accepted argument counts are stored as a half-open range
+    Overload_Bucket range = {0};
+    if (value_is_function_literal(value)) {
+      const Function_Literal *literal = value_as_function_literal(value);
+      Array_Function_Parameter params = literal->header.parameters;
+      range.to = (u32)dyn_array_length(params) + 1;
+      for (u64 i = 0; i < dyn_array_length(params); ++i) {
+        if (!dyn_array_get(params, i)->maybe_default_value) range.from = (u32)i + 1;
       }
-      Function_Info *specialized_info;
-      {
-        // :OverloadLock
-        // A literal must be locked here to allow using its overload to be used
-        // inside the function signature. Here's an example:
-        //    pointer_to :: fn(type : Type) => (Type) MASS.pointer_to_type
-        //    pointer_to :: fn(x) -> (pointer_to(x)) MASS.pointer_to
-        // Without the lock the second literal will infinitely recurse
-        *literal->overload_lock_count += 1;
-        specialized_info = function_literal_info_for_parameters(context, literal, args->parameters);
-        *literal->overload_lock_count -= 1;
+      candidate.requires_compile_time_arguments =
+        !!(literal->header.flags & Function_Header_Flags_Compile_Time);
+      if (dyn_array_length(params)) {
+        const Function_Parameter *first = dyn_array_get(params, 0);
+        switch(first->tag) {
+          case Function_Parameter_Tag_Runtime: {
+            if (first->descriptor) {
+              candidate.first_parameter = Overload_First_Parameter_Runtime;
+              candidate.first_parameter_kind = same_type_hash(first->descriptor);
+            }
+          } break;
+          case Function_Parameter_Tag_Generic: {
+            if (first->Generic.is_static) {
+              candidate.first_parameter = Overload_First_Parameter_Generic_Static;
+            }
+          } break;
+          case Function_Parameter_Tag_Exact_Static: {
+            candidate.first_parameter = Overload_First_Parameter_Exact_Static;
+            candidate.first_parameter_kind = same_type_hash(first->descriptor);
+          } break;
+        }
       }
-      overload_info = specialized_info;
-      if (!overload_info) return;
     } else {
-      const Descriptor *descriptor = candidate->descriptor;
-      const Descriptor_Function_Instance *instance = descriptor_as_function_instance(descriptor);
-      overload_info = instance->info;
-      if (overload_info->flags & Function_Info_Flags_Compile_Time) {
-        assert(instance->program == context->compilation->jit.program);
-        if (!args->all_arguments_are_compile_time_known) return;
-        scoring_flags |= Mass_Argument_Scoring_Flags_Prefer_Compile_Time;
-      } else {
-        if (instance->program && instance->program != context->program) return;
+      const Function_Info *info = descriptor_as_function_instance(value->descriptor)->info;
+      // Missing arguments of an instance are always filled in with defaults
+      range.to = (u32)dyn_array_length(info->parameters) + 1;
+      candidate.requires_compile_time_arguments = !!(info->flags & Function_Info_Flags_Compile_Time);
+      if (dyn_array_length(info->parameters)) {
+        const Resolved_Function_Parameter *first = dyn_array_get(info->parameters, 0);
+        candidate.first_parameter = first->tag == Resolved_Function_Parameter_Tag_Known
+          ? Overload_First_Parameter_Exact_Static
+          : Overload_First_Parameter_Runtime;
+        candidate.first_parameter_kind = same_type_hash(first->descriptor);
       }
     }
+    dyn_array_push(*candidates, candidate);
+    dyn_array_push(*ranges, range);
+  }
+}
 
-    Overload_Match_Summary summary = calculate_arguments_match_score(
-      context, overload_info, args->parameters, scoring_flags
-    );
-    if (summary.matched) {
-      dyn_array_push(matches, (Overload_Match_State) {
-        .info = overload_info,
-        .value = candidate,
-        .summary = summary,
-      });
+// Flattens the set and buckets candidates by the argument count they accept,
+// keeping the definition order within each bucket
+static void
+mass_overload_ensure_buckets(
+  Mass_Context *context,
+  const Overload *overload
+) {
+  if (dyn_array_is_initialized(overload->buckets)) return;
+  Array_Overload_Candidate flat = dyn_array_make(
+    Array_Overload_Candidate, .allocator = context->temp_allocator, .capacity = 32,
+  );
+  Array_Overload_Bucket ranges = dyn_array_make(
+    Array_Overload_Bucket, .allocator = context->temp_allocator, .capacity = 32,
+  );
+  mass_overload_collect_candidates(overload, &flat, &ranges);
+
+  u32 bucket_count = 0;
+  DYN_ARRAY_FOREACH(Overload_Bucket, range, ranges) {
+    bucket_count = u32_max(bucket_count, range->to);
+  }
+  // FIXME @ConstCast the buckets are a cache and do not change the contents of the set
+  Overload *mutable_overload = (Overload *)overload;
+  mutable_overload->candidates = dyn_array_make(
+    Array_Overload_Candidate, .allocator = context->allocator, .capacity = dyn_array_length(flat),
+  );
+  mutable_overload->buckets = dyn_array_make(
+    Array_Overload_Bucket, .allocator = context->allocator, .capacity = bucket_count,
+  );
+  for (u32 argument_count = 0; argument_count < bucket_count; ++argument_count) {
+    Overload_Bucket bucket = { .from = (u32)dyn_array_length(mutable_overload->candidates) };
+    for (u64 i = 0; i < dyn_array_length(flat); ++i) {
+      const Overload_Bucket *range = dyn_array_get(ranges, i);
+      if (argument_count < range->from || argument_count >= range->to) continue;
+      dyn_array_push(mutable_overload->candidates, *dyn_array_get(flat, i));
     }
+    bucket.to = (u32)dyn_array_length(mutable_overload->candidates);
+    dyn_array_push(mutable_overload->buckets, bucket);
   }
 }
 
+// :OverloadPrefilter
+// Rejects candidates that can not match based on the first argument without looking
+// at the function itself. Only the necessary conditions are checked here, the precise
+// ones are in `calculate_arguments_match_score` and `function_literal_info_for_parameters`:
+//   * a runtime argument can only match a runtime parameter of the same type,
+//   * a static parameter can only be matched by a compile-time known argument.
+static inline bool
+mass_overload_candidate_may_match(
+  const Overload_Candidate *candidate,
+  const Mass_Overload_Match_Args *args,
+  const Resolved_Function_Parameter *first_arg,
+  u64 first_arg_kind
+) {
+  if (candidate->requires_compile_time_arguments && !args->all_arguments_are_compile_time_known) {
+    return false;
+  }
+  if (!first_arg) return true;
+  bool known = first_arg->tag == Resolved_Function_Parameter_Tag_Known;
+  switch(candidate->first_parameter) {
+    case Overload_First_Parameter_Any: return true;
+    case Overload_First_Parameter_Runtime: {
+      // Compile-time known arguments might be converted to the target type
+      return known || candidate->first_parameter_kind == first_arg_kind;
+    }
+    case Overload_First_Parameter_Exact_Static: {
+      return known && candidate->first_parameter_kind == first_arg_kind;
+    }
+    case Overload_First_Parameter_Generic_Static: return known;
+  }
+  return true;
+}
+
 static Overload_Match
-mass_match_overload(
+mass_match_overload_uncached(
   Mass_Context *context,
   Value *value,
   Array_Resolved_Function_Parameter parameters
@@ -3491,13 +4236,31 @@ mass_match_overload(
       break;
     }
   }
-  // TODO Store overload count on the Overload to know how much to reserve here
-  Array_Overload_Match_State matches = dyn_array_make(
-    Array_Overload_Match_State,
-    .capacity = 16,
-    .allocator = context->temp_allocator,
-  );
-  mass_match_overload_candidate(context, value, &args, matches);
+  Array_Overload_Match_State matches;
+  if (value_is_overload(value)) {
+    const Overload *overload = value_as_overload(value);
+    mass_overload_ensure_buckets(context, overload);
+    u64 argument_count = dyn_array_length(parameters);
+    if (argument_count >= dyn_array_length(overload->buckets)) {
+      return (Overload_Match){.tag = Overload_Match_Tag_No_Match};
+    }
+    const Overload_Bucket *bucket = dyn_array_get(overload->buckets, argument_count);
+    matches = dyn_array_make(
+      Array_Overload_Match_State,
+      .capacity = u32_max(bucket->to - bucket->from, 1),
+      .allocator = context->temp_allocator,
+    );
+    const Resolved_Function_Parameter *first_arg = argument_count ? dyn_array_get(parameters, 0) : 0;
+    u64 first_arg_kind = first_arg ? same_type_hash(first_arg->descriptor) : 0;
+    for (u32 i = bucket->from; i < bucket->to; ++i) {
+      const Overload_Candidate *candidate = dyn_array_get(overload->candidates, i);
+      if (!mass_overload_candidate_may_match(candidate, &args, first_arg, first_arg_kind)) continue;
+      mass_match_overload_candidate(context, candidate->value, &args, matches);
+    }
+  } else {
+    matches = dyn_array_make(Array_Overload_Match_State, .capacity = 1, .allocator = context->temp_allocator);
+    mass_match_overload_candidate(context, value, &args, matches);
+  }
   if (!dyn_array_length(matches)) {
     return (Overload_Match){.tag = Overload_Match_Tag_No_Match};
   }
@@ -3545,6 +4308,135 @@ mass_match_overload(
 
 }
 
+// Cached entries outlive the temp arena so anything a lookup key compares by address
+// must not live there, as the address could be reused for something different
+static bool
+mass_overload_match_is_cacheable(
+  const Compilation *compilation,
+  const Value *overload_set,
+  Array_Resolved_Function_Parameter arguments
+) {
+  const Virtual_Memory_Buffer *permanent = &compilation->allocation_buffer;
+  const s8 *set_address = (const s8 *)overload_set;
+  if (set_address < permanent->memory || set_address >= permanent->memory + permanent->occupied) {
+    return false;
+  }
+  DYN_ARRAY_FOREACH(Resolved_Function_Parameter, arg, arguments) {
+    if (mass_is_temp_address(compilation, arg->descriptor)) return false;
+    if (arg->tag != Resolved_Function_Parameter_Tag_Known) continue;
+    if (arg->descriptor->tag == Descriptor_Tag_Function_Instance) return false;
+    const Storage *storage = &arg->Known.storage;
+    u64 byte_size = descriptor_byte_size(arg->descriptor);
+    if (byte_size > 64) return false;
+    const void *memory = storage_static_memory_with_bit_size(storage, arg->descriptor->bit_size);
+    if (mass_is_temp_address(compilation, memory)) return false;
+    // Type values and other pointers are compared by address as well
+    for (u64 offset = 0; offset + sizeof(u64) <= byte_size; offset += sizeof(u64)) {
+      u64 word;
+      memcpy(&word, (const s8 *)memory + offset, sizeof(word));
+      if (mass_is_temp_address(compilation, (const void *)(uintptr_t)word)) return false;
+    }
+  }
+  return true;
+}
+
+static u64
+mass_overload_match_cache_hash(
+  const Value *overload_set,
+  const Program *program,
+  Array_Resolved_Function_Parameter arguments
+) {
+  u64 hash = hash_u64((u64)(uintptr_t)overload_set ^ ((u64)(uintptr_t)program << 16));
+  DYN_ARRAY_FOREACH(Resolved_Function_Parameter, arg, arguments) {
+    hash = hash_u64(hash ^ (u64)(uintptr_t)arg->descriptor ^ arg->tag);
+    if (arg->tag != Resolved_Function_Parameter_Tag_Known) continue;
+    // Only hash values that can be compared with a memcmp, other ones will share a chain
+    switch(arg->descriptor->tag) {
+      case Descriptor_Tag_Float:
+      case Descriptor_Tag_Integer:
+      case Descriptor_Tag_Raw:
+      case Descriptor_Tag_Pointer_To: {
+        const void *memory = storage_static_memory_with_bit_size(
+          &arg->Known.storage, arg->descriptor->bit_size
+        );
+        hash ^= hash_bytes(memory, descriptor_byte_size(arg->descriptor));
+      } break;
+      default: break;
+    }
+  }
+  return hash;
+}
+
+static bool
+mass_overload_match_cache_entry_matches(
+  const Overload_Match_Cache_Entry *entry,
+  const Value *overload_set,
+  const Program *program,
+  Array_Resolved_Function_Parameter arguments
+) {
+  if (entry->overload_set != overload_set || entry->program != program) return false;
+  if (dyn_array_length(entry->arguments) != dyn_array_length(arguments)) return false;
+  for (u64 i = 0; i < dyn_array_length(arguments); ++i) {
+    const Resolved_Function_Parameter *cached = dyn_array_get(entry->arguments, i);
+    const Resolved_Function_Parameter *arg = dyn_array_get(arguments, i);
+    if (cached->tag != arg->tag || cached->descriptor != arg->descriptor) return false;
+    if (arg->tag == Resolved_Function_Parameter_Tag_Known) {
+      if (!storage_static_equal(
+        cached->descriptor, &cached->Known.storage, arg->descriptor, &arg->Known.storage
+      )) return false;
+    }
+  }
+  return true;
+}
+
+// Overload sets are immutable values: `scope_define_value` publishes a new set every
+// time an overload is added, so keying the cache by the set invalidates old results.
+// While a literal is locked in :OverloadLock it is not a candidate so the result
+// could differ from the cached one, which is why the cache is skipped altogether.
+static Overload_Match
+mass_match_overload(
+  Mass_Context *context,
+  Value *value,
+  Array_Resolved_Function_Parameter parameters
+) {
+  Compilation *compilation = context->compilation;
+  bool cacheable =
+    !compilation->overload_lock_depth &&
+    mass_overload_match_is_cacheable(compilation, value, parameters);
+  if (!cacheable) {
+    return mass_match_overload_uncached(context, value, parameters);
+  }
+
+  u64 hash = mass_overload_match_cache_hash(value, context->program, parameters);
+  Overload_Match_Cache_Entry **chain_pointer = hash_map_get(compilation->overload_match_cache_map, hash);
+  Overload_Match_Cache_Entry *chain = chain_pointer ? *chain_pointer : 0;
+  for (Overload_Match_Cache_Entry *entry = chain; entry; entry = entry->next) {
+    if (mass_overload_match_cache_entry_matches(entry, value, context->program, parameters)) {
+      compilation->counters.overload_match_cache_hits += 1;
+      return entry->match;
+    }
+  }
+  compilation->counters.overload_match_cache_misses += 1;
+
+  Overload_Match match = mass_match_overload_uncached(context, value, parameters);
+  // Undecidable matches are always reported as errors so there is no point caching them
+  if (mass_has_error(context) || match.tag == Overload_Match_Tag_Undecidable) return match;
+
+  Overload_Match_Cache_Entry *entry = allocator_allocate(compilation->allocator, Overload_Match_Cache_Entry);
+  *entry = (Overload_Match_Cache_Entry) {
+    .overload_set = value,
+    .program = context->program,
+    .match = match,
+    .next = chain,
+  };
+  dyn_array_copy_from_raw_memory(
+    Array_Resolved_Function_Parameter, compilation->allocator, &entry->arguments,
+    dyn_array_raw(parameters), dyn_array_length(parameters)
+  );
+  hash_map_set(compilation->overload_match_cache_map, hash, entry);
+  return match;
+}
+
 static bool
 mass_match_overload_or_error(
   Mass_Context *context,
@@ -3642,6 +4534,54 @@ value_is_intrinsic(
   return false;
 }
 
+// System V passes up to six integer arguments in registers. Win64 only has four
+// but the C compiler handles the remaining stack slots for us.
+#define MASS_TRAMPOLINE_DIRECT_MAX_ARGUMENT_COUNT 6
+
+static bool
+mass_trampoline_descriptor_fits_integer_register(
+  const Descriptor *descriptor
+) {
+  switch(descriptor->tag) {
+    case Descriptor_Tag_Integer:
+    case Descriptor_Tag_Raw: {
+      u64 byte_size = descriptor_byte_size(descriptor);
+      return byte_size == 1 || byte_size == 2 || byte_size == 4 || byte_size == 8;
+    }
+    case Descriptor_Tag_Pointer_To:
+    case Descriptor_Tag_Function_Instance: {
+      return true;
+    }
+    case Descriptor_Tag_Void:
+    case Descriptor_Tag_Never:
+    case Descriptor_Tag_Float:
+    case Descriptor_Tag_Fixed_Array:
+    case Descriptor_Tag_Struct: {
+      return false;
+    }
+  }
+  return false;
+}
+
+// Functions that take a few scalar arguments and return a scalar can be called
+// directly from C with the host calling convention, which loads the arguments
+// straight into registers instead of going through a generic args struct.
+static bool
+mass_trampoline_can_call_directly(
+  const Function_Info *info
+) {
+  u64 parameter_count = dyn_array_length(info->parameters);
+  if (parameter_count > MASS_TRAMPOLINE_DIRECT_MAX_ARGUMENT_COUNT) return false;
+  for (u64 i = 0; i < parameter_count; ++i) {
+    const Resolved_Function_Parameter *param = dyn_array_get(info->parameters, i);
+    if (param->tag == Resolved_Function_Parameter_Tag_Known) return false;
+    if (!mass_trampoline_descriptor_fits_integer_register(param->descriptor)) return false;
+  }
+  const Descriptor *return_descriptor = info->return_descriptor;
+  if (mass_descriptor_is_void(return_descriptor)) return true;
+  return mass_trampoline_descriptor_fits_integer_register(return_descriptor);
+}
+
 static const Mass_Trampoline *
 mass_ensure_trampoline(
   Mass_Context *context,
@@ -3693,6 +4633,19 @@ mass_ensure_trampoline(
     proxy_value = value_make(context, proxy_descriptor, *runtime_storage, original->source_range);
   }
 
+  if (mass_trampoline_can_call_directly(original_info)) {
+    const Function_Info *proxy_info = descriptor_as_function_instance(proxy_value->descriptor)->info;
+    fn_type_opaque direct_proc = mass_ensure_jit_function_for_value(context, proxy_value, proxy_info);
+    if (mass_has_error(context)) return 0;
+    Mass_Trampoline *trampoline = allocator_allocate(context->allocator, Mass_Trampoline);
+    *trampoline = (Mass_Trampoline) {
+      .original_info = original_info,
+      .direct_proc = (const void *)direct_proc,
+    };
+    hash_map_set(context->compilation->trampoline_map, original_info, trampoline);
+    return trampoline;
+  }
+
   C_Struct_Aligner struct_aligner = {0};
   Array_Struct_Field fields = dyn_array_make(
     Array_Struct_Field,
@@ -3714,13 +4667,21 @@ mass_ensure_trampoline(
 
   c_struct_aligner_end(&struct_aligner);
 
-  Descriptor *args_struct_descriptor = allocator_allocate(context->allocator, Descriptor);
-  *args_struct_descriptor = (Descriptor) {
+  // Trampolines for calls with the same argument layout share the args struct descriptor
+  Descriptor args_struct_candidate = {
     .tag = Descriptor_Tag_Struct,
     .bit_size = {struct_aligner.bit_size},
     .bit_alignment = {struct_aligner.bit_alignment},
     .Struct = { .fields = fields, },
   };
+  const Descriptor *args_struct_descriptor =
+    descriptor_intern(context->compilation, &args_struct_candidate);
+  if (args_struct_descriptor == &args_struct_candidate) {
+    // The fields are already allocated in the permanent arena
+    Descriptor *copy = mass_allocate(context, Descriptor);
+    *copy = args_struct_candidate;
+    args_struct_descriptor = copy;
+  }
 
   // The code below is a specialized version of `mass_function_literal_instance_for_info`.
   // This avoids generating a literal with a text version of the body.
@@ -3836,6 +4797,62 @@ mass_ensure_trampoline(
   return trampoline;
 }
 
+static Value *
+mass_trampoline_call_direct(
+  Mass_Context *context,
+  const Mass_Trampoline *trampoline,
+  Value_View args_view
+) {
+  u64 arguments[MASS_TRAMPOLINE_DIRECT_MAX_ARGUMENT_COUNT] = {0};
+  assert(args_view.length <= countof(arguments));
+  for (u64 i = 0; i < args_view.length; ++i) {
+    Value* item = value_view_get(&args_view, i);
+    assert(mass_value_is_static(item));
+    const Descriptor *descriptor = item->descriptor;
+    u64 byte_size = descriptor_byte_size(descriptor);
+    const void* source_memory = storage_static_memory_with_bit_size(
+      &value_as_forced(item)->storage, descriptor->bit_size
+    );
+    memcpy(&arguments[i], source_memory, byte_size);
+    // C compilers expect small signed integers to be sign-extended by the caller
+    if (descriptor_is_signed_integer(descriptor) && byte_size < 8) {
+      u64 shift = 64 - descriptor->bit_size.as_u64;
+      arguments[i] = (u64)((s64)(arguments[i] << shift) >> shift);
+    }
+  }
+
+  typedef u64 (*Direct_Proc_0)(void);
+  typedef u64 (*Direct_Proc_1)(u64);
+  typedef u64 (*Direct_Proc_2)(u64, u64);
+  typedef u64 (*Direct_Proc_3)(u64, u64, u64);
+  typedef u64 (*Direct_Proc_4)(u64, u64, u64, u64);
+  typedef u64 (*Direct_Proc_5)(u64, u64, u64, u64, u64);
+  typedef u64 (*Direct_Proc_6)(u64, u64, u64, u64, u64, u64);
+
+  fn_type_opaque proc = (fn_type_opaque)trampoline->direct_proc;
+  u64 *a = arguments;
+  u64 returned = 0;
+  switch(args_view.length) {
+    case 0: returned = ((Direct_Proc_0)proc)(); break;
+    case 1: returned = ((Direct_Proc_1)proc)(a[0]); break;
+    case 2: returned = ((Direct_Proc_2)proc)(a[0], a[1]); break;
+    case 3: returned = ((Direct_Proc_3)proc)(a[0], a[1], a[2]); break;
+    case 4: returned = ((Direct_Proc_4)proc)(a[0], a[1], a[2], a[3]); break;
+    case 5: returned = ((Direct_Proc_5)proc)(a[0], a[1], a[2], a[3], a[4]); break;
+    case 6: returned = ((Direct_Proc_6)proc)(a[0], a[1], a[2], a[3], a[4], a[5]); break;
+    default: {
+      panic("Unexpected argument count for a direct trampoline call");
+    } break;
+  }
+
+  // Only the low bytes of the return register are defined for smaller types
+  const Descriptor *return_descriptor = trampoline->original_info->return_descriptor;
+  void *return_memory = mass_allocate_bytes_from_descriptor(context, return_descriptor);
+  memcpy(return_memory, &returned, descriptor_byte_size(return_descriptor));
+  Storage return_storage = storage_static_heap(return_memory, return_descriptor->bit_size);
+  return value_make(context, return_descriptor, return_storage, args_view.source_range);
+}
+
 static Value *
 mass_trampoline_call(
   Mass_Context *context,
@@ -3848,6 +4865,12 @@ mass_trampoline_call(
     mass_ensure_trampoline(context, parser, original, original_info, args_view);
   if (mass_has_error(context)) return 0;
 
+  if (trampoline->direct_proc) {
+    context->compilation->counters.trampoline_direct_call_count += 1;
+    return mass_trampoline_call_direct(context, trampoline, args_view);
+  }
+  context->compilation->counters.trampoline_struct_call_count += 1;
+
   Temp_Mark temp_mark = context_temp_mark(context);
   u64 bit_size = trampoline->args_descriptor->bit_size.as_u64;
   u8* args_struct_memory = 0;
@@ -4974,6 +5997,7 @@ mass_define_stack_value_from_typed_symbol(
   //      long term, but it is good for experimentation at the moment.
   parser->scope = scope_make_imperative(context->allocator, parser->scope, &(const Scope_Entry) {
     .value = defined,
+    .symbol = typed_symbol->symbol,
     .name = typed_symbol->symbol->name,
     .epoch = parser->epoch,
     .source_range = source_range
@@ -5013,24 +6037,41 @@ mass_operator_assignment(
   );
 }
 
+static inline bool
+mass_eval_ensure_body(
+  Mass_Context *context,
+  Value_View args_view
+) {
+  assert(args_view.length == 1);
+  Value *body = value_view_get(&args_view, 0);
+  if (value_is_group_paren(body) || value_is_ast_block(body)) return true;
+  mass_error(context, (Mass_Error) {
+    .tag = Mass_Error_Tag_Parse,
+    .source_range = args_view.source_range,
+    .detailed_message = slice_literal("@ operator must be followed by an expression in () or {}"),
+  });
+  return false;
+}
+
 static Value *
 mass_eval(
   Mass_Context *context,
   Parser *parser,
   Value_View args_view
 ) {
-  assert(args_view.length == 1);
-  Value *body = value_view_get(&args_view, 0);
-  if (value_is_group_paren(body) || value_is_ast_block(body)) {
-    return compile_time_eval(context, parser, args_view);
-  } else {
-    mass_error(context, (Mass_Error) {
-      .tag = Mass_Error_Tag_Parse,
-      .source_range = args_view.source_range,
-      .detailed_message = slice_literal("@ operator must be followed by an expression in () or {}"),
-    });
-    return 0;
-  }
+  if (!mass_eval_ensure_body(context, args_view)) return 0;
+  return compile_time_eval_memoized(context, parser, args_view);
+}
+
+// Same as `mass_eval`, but always runs the expression. Used for evaluations with side effects.
+static Value *
+mass_eval_uncached(
+  Mass_Context *context,
+  Parser *parser,
+  Value_View args_view
+) {
+  if (!mass_eval_ensure_body(context, args_view)) return 0;
+  return compile_time_eval(context, parser, args_view);
 }
 
 typedef struct {
@@ -5076,6 +6117,188 @@ mass_handle_field_access_lazy_proc(
   );
 }
 
+// :CompileTimeInterpreter
+// Most of `@` evaluations are simple arithmetic, comparisons, casts and field reads
+// on static values. Walking the lazy value tree directly is much cheaper than
+// generating machine code, committing it to the JIT program and calling into it.
+// Anything that is not understood here returns 0 so the caller falls back to the JIT.
+static bool
+mass_interpret_static_integer_bits(
+  const Value *value,
+  u64 *out_bits
+) {
+  if (!mass_value_is_static(value)) return false;
+  const Descriptor *descriptor = value->descriptor;
+  if (!descriptor_is_integer(descriptor)) return false;
+  u64 bit_size = descriptor->bit_size.as_u64;
+  if (!bit_size || bit_size > 64 || bit_size % CHAR_BIT) return false;
+
+  const void *memory = storage_static_memory_with_bit_size(
+    &value_as_forced(value)->storage, descriptor->bit_size
+  );
+  u64 bits = 0;
+  memcpy(&bits, memory, bit_size / CHAR_BIT);
+  // Sign-extend so that the operations below can work on full 64-bit values
+  if (descriptor_is_signed_integer(descriptor) && bit_size != 64) {
+    u64 shift = 64 - bit_size;
+    bits = (u64)((s64)(bits << shift) >> shift);
+  }
+  *out_bits = bits;
+  return true;
+}
+
+static Value *
+mass_interpret_arithmetic(
+  Mass_Context *context,
+  Value *lazy_value,
+  const Mass_Arithmetic_Operator_Lazy_Payload *payload,
+  Value *lhs,
+  Value *rhs
+) {
+  u64 a;
+  u64 b;
+  if (!mass_interpret_static_integer_bits(lhs, &a)) return 0;
+  if (!mass_interpret_static_integer_bits(rhs, &b)) return 0;
+
+  const Descriptor *descriptor = lazy_value->descriptor;
+  if (!same_type(descriptor, lhs->descriptor)) return 0;
+  bool is_signed = descriptor_is_signed_integer(descriptor);
+  u64 bit_size = descriptor->bit_size.as_u64;
+
+  u64 result;
+  switch(payload->operator) {
+    case Mass_Arithmetic_Operator_Add: result = a + b; break;
+    case Mass_Arithmetic_Operator_Subtract: result = a - b; break;
+    // Lower bits of the product are the same for signed and unsigned multiplication
+    case Mass_Arithmetic_Operator_Multiply: result = a * b; break;
+    case Mass_Arithmetic_Operator_Divide:
+    case Mass_Arithmetic_Operator_Remainder: {
+      // Let the JIT code trap in the same way the runtime code would
+      if (b == 0) return 0;
+      if (is_signed) {
+        s64 min = (s64)((u64)1 << 63) >> (64 - bit_size);
+        if ((s64)a == min && (s64)b == -1) return 0;
+        result = payload->operator == Mass_Arithmetic_Operator_Divide
+          ? (u64)((s64)a / (s64)b)
+          : (u64)((s64)a % (s64)b);
+      } else {
+        result = payload->operator == Mass_Arithmetic_Operator_Divide ? a / b : a % b;
+      }
+    } break;
+    default: {
+      return 0;
+    }
+  }
+
+  return value_make(
+    context, descriptor, storage_immediate_with_bit_size(&result, descriptor->bit_size),
+    lazy_value->source_range
+  );
+}
+
+static Value *
+mass_interpret_integer_comparison(
+  Mass_Context *context,
+  Value *lazy_value,
+  Compare_Type compare_type,
+  Value *lhs,
+  Value *rhs
+) {
+  u64 a;
+  u64 b;
+  if (!mass_interpret_static_integer_bits(lhs, &a)) return 0;
+  if (!mass_interpret_static_integer_bits(rhs, &b)) return 0;
+  if (!same_type(lhs->descriptor, rhs->descriptor)) return 0;
+
+  // Operators are parsed as signed compares, see mass_handle_integer_comparison_lazy_proc
+  bool is_signed = descriptor_is_signed_integer(lhs->descriptor);
+  bool result;
+  switch(compare_type) {
+    case Compare_Type_Equal: result = a == b; break;
+    case Compare_Type_Not_Equal: result = a != b; break;
+    case Compare_Type_Signed_Less: result = is_signed ? (s64)a < (s64)b : a < b; break;
+    case Compare_Type_Signed_Less_Equal: result = is_signed ? (s64)a <= (s64)b : a <= b; break;
+    case Compare_Type_Signed_Greater: result = is_signed ? (s64)a > (s64)b : a > b; break;
+    case Compare_Type_Signed_Greater_Equal: result = is_signed ? (s64)a >= (s64)b : a >= b; break;
+    default: {
+      return 0;
+    }
+  }
+
+  return value_make(context, &descriptor__bool, storage_immediate(&result), lazy_value->source_range);
+}
+
+static Value *
+mass_interpret(
+  Mass_Context *context,
+  Value *value
+) {
+  if (mass_has_error(context)) return 0;
+  if (mass_value_is_static(value)) return value;
+  if (value->tag != Value_Tag_Lazy) return 0;
+
+  const Value_Lazy *lazy = &value->Lazy;
+  const Source_Range *source_range = &value->source_range;
+
+  if (lazy->proc == (Lazy_Value_Proc)mass_handle_arithmetic_operation_lazy_proc) {
+    const Mass_Arithmetic_Operator_Lazy_Payload *payload = lazy->payload;
+    Value *lhs = mass_interpret(context, payload->lhs);
+    if (!lhs) return 0;
+    Value *rhs = mass_interpret(context, payload->rhs);
+    if (!rhs) return 0;
+    return mass_interpret_arithmetic(context, value, payload, lhs, rhs);
+  }
+
+  if (lazy->proc == (Lazy_Value_Proc)mass_handle_integer_comparison_lazy_proc) {
+    const Mass_Comparison_Operator_Lazy_Payload *payload = lazy->payload;
+    Value *lhs = mass_interpret(context, payload->lhs);
+    if (!lhs) return 0;
+    Value *rhs = mass_interpret(context, payload->rhs);
+    if (!rhs) return 0;
+    return mass_interpret_integer_comparison(context, value, payload->compare_type, lhs, rhs);
+  }
+
+  if (lazy->proc == (Lazy_Value_Proc)mass_cast_lazy_proc) {
+    const Mass_Cast_Lazy_Payload *payload = lazy->payload;
+    Value *expression = mass_interpret(context, payload->expression);
+    if (!expression) return 0;
+    Mass_Cast_Lazy_Payload static_payload = { .target = payload->target, .expression = expression };
+    Expected_Result expected_result = expected_result_any(payload->target);
+    return mass_cast_lazy_proc(context, 0, &expected_result, lazy->scope, source_range, &static_payload);
+  }
+
+  if (lazy->proc == (Lazy_Value_Proc)mass_zero_extend_lazy_proc) {
+    const Mass_Cast_Lazy_Payload *payload = lazy->payload;
+    Value *expression = mass_interpret(context, payload->expression);
+    if (!expression || !mass_value_is_static(expression)) return 0;
+    Bits source_bit_size = expression->descriptor->bit_size;
+    Bits target_bit_size = payload->target->bit_size;
+    if (target_bit_size.as_u64 > 64 || source_bit_size.as_u64 > target_bit_size.as_u64) return 0;
+    if (source_bit_size.as_u64 % CHAR_BIT) return 0;
+    const void *memory = storage_static_memory_with_bit_size(
+      &value_as_forced(expression)->storage, source_bit_size
+    );
+    u64 bits = 0;
+    memcpy(&bits, memory, source_bit_size.as_u64 / CHAR_BIT);
+    return value_make(
+      context, payload->target, storage_immediate_with_bit_size(&bits, target_bit_size), *source_range
+    );
+  }
+
+  if (lazy->proc == (Lazy_Value_Proc)mass_handle_field_access_lazy_proc) {
+    const Mass_Field_Access_Lazy_Payload *payload = lazy->payload;
+    Value *struct_ = mass_interpret(context, payload->struct_);
+    if (!struct_) return 0;
+    Mass_Field_Access_Lazy_Payload static_payload = { .struct_ = struct_, .field = payload->field };
+    Expected_Result expected_result = expected_result_any(payload->field->descriptor);
+    return mass_handle_field_access_lazy_proc(
+      context, 0, &expected_result, lazy->scope, source_range, &static_payload
+    );
+  }
+
+  return 0;
+}
+
 typedef struct {
   Value *array;
   Value *index;
@@ -5387,7 +6610,7 @@ mass_struct_get(
     if (!mass_value_ensure_static_of(context, rhs, &descriptor_symbol)) return 0;
     const Symbol *symbol = value_as_symbol(rhs);
 
-    if (!struct_find_field_by_name(unwrapped_lhs_descriptor, symbol->name, &field, &(u64){0})) {
+    if (!struct_find_field_by_name(context->compilation, unwrapped_lhs_descriptor, symbol->name, &field, &(u64){0})) {
       mass_error(context, (Mass_Error) {
         .tag = Mass_Error_Tag_Unknown_Field,
         .source_range = rhs->source_range,
@@ -6409,6 +7632,7 @@ token_parse_block(
   const Ast_Block *group,
   const Source_Range *source_range
 ) {
+  tokenizer_ast_block_ensure_built(context, group);
   Parser block_parser = *parser;
   block_parser.scope = scope_make_declarative(context->allocator, parser->scope);
   return token_parse_block_statements(context, &block_parser, group->first_statement, source_range);
@@ -6503,6 +7727,7 @@ token_define_local_variable(
   // :ScopeForEachDeclaration
   parser->scope = scope_make_imperative(context->allocator, parser->scope, &(const Scope_Entry) {
     .value = variable_value,
+    .symbol = value_as_symbol(symbol),
     .name = value_as_symbol(symbol)->name,
     .epoch = parser->epoch,
     .source_range = *source_range
@@ -6631,9 +7856,9 @@ mass_compilation_init_scopes(
 ) {
   Mass_Context context = mass_context_from_compilation(compilation);
   const Allocator *allocator = compilation->allocator;
-  Scope *root_scope =  scope_make_declarative(compilation->allocator, 0);
+  Scope *root_scope =  scope_make_declarative_indexed(compilation->allocator, 0);
   compilation->root_scope = root_scope;
-  Scope *module_scope = scope_make_declarative(allocator, root_scope);
+  Scope *module_scope = scope_make_declarative_indexed(allocator, root_scope);
   compilation->compiler_module = (Module) {
     .source_range = {0},
     .own_scope = module_scope,
@@ -6704,6 +7929,7 @@ mass_compilation_init_scopes(
   MASS_INTRINSIC_OPERATOR(":", Operator_Flags_None, Infix, 2, "typed_symbol");
 
   MASS_INTRINSIC_OPERATOR("@", Operator_Flags_None, Prefix, 20, "eval");
+  MASS_INTRINSIC_OPERATOR("@!", Operator_Flags_None, Prefix, 20, "eval_uncached");
   MASS_INTRINSIC_OPERATOR(".", Operator_Flags_None, Prefix, 30, "named_accessor");
   MASS_INTRINSIC_OPERATOR("...", Operator_Flags_None, Prefix, 1, "spread");
 
@@ -6781,6 +8007,7 @@ mass_inline_module(
   Value *arg_value = value_view_get(&args, 0);
   if (!mass_value_ensure_static_of(context, arg_value, &descriptor_ast_block)) return 0;
   const Ast_Block *curly = value_as_ast_block(arg_value);
+  tokenizer_ast_block_ensure_built(context, curly);
 
   Module *module = mass_allocate(context, Module);
   *module = (Module) {
@@ -6898,8 +8125,11 @@ program_module_from_file(
   *file = (Source_File) {
     .path = file_path,
   };
-  Fixed_Buffer *buffer = fixed_buffer_from_file(file_path);
-  if (!buffer) {
+  // The file is mapped instead of read so that the tokenizer and all the
+  // source ranges refer straight to the page cache without an extra copy.
+  // The mapping is owned by the compilation and released in `compilation_deinit`.
+  File_Mapping mapping;
+  if (!file_mapping_open(file_path, &mapping, 0)) {
     Source_Range error_source_range = { .file = file, .offsets = {0} };
     mass_error(context, (Mass_Error) {
       .tag = Mass_Error_Tag_File_Open,
@@ -6909,9 +8139,10 @@ program_module_from_file(
     });
     return 0;
   }
-  file->text = fixed_buffer_as_slice(buffer);
+  dyn_array_push(context->compilation->source_file_mappings, mapping);
+  file->text = mapping.contents;
 
-  if (buffer->occupied > UINT32_MAX) {
+  if (file->text.length > UINT32_MAX) {
     mass_error(context, (Mass_Error) {
       .tag = Mass_Error_Tag_File_Too_Large,
       .File_Too_Large = { .path = file_path },
@@ -6927,7 +8158,7 @@ program_module_from_file(
   *module = (Module) {
     .source_range = {
       .file = file,
-      .offsets = {.from = 0, .to = u64_to_u32(buffer->occupied)}
+      .offsets = {.from = 0, .to = u64_to_u32(file->text.length)}
     },
     .own_scope = scope,
   };
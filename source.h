@@ -112,6 +112,12 @@ compile_time_eval(
   Value_View view
 );
 
+static Value *
+mass_interpret(
+  Mass_Context *context,
+  Value *value
+);
+
 static Value *
 token_parse_expression(
   Mass_Context *context,
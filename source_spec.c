@@ -1,3 +1,7 @@
+// Needs to come before system headers included by bdd-for-c.h, see prelude.h
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include "bdd-for-c.h"
 
 #include "pe32.c"
@@ -49,6 +53,8 @@ spec_check_mass_result_internal(
 typedef u64 (*Spec_Callback)();
 static u64 spec_callback() { return 42; }
 
+hash_map_template(Spec_Pointer_Map, const void *, u64, hash_pointer, const_void_pointer_equal)
+
 #define spec_check_slice(_ACTUAL_, _EXPECTED_)\
   do {\
     Slice actual = (_ACTUAL_);\
@@ -91,6 +97,153 @@ test_inline_source_range(
   };
 }
 
+static bool
+spec_value_views_equal(
+  Mass_Context *context,
+  const Value_View *a,
+  const Value_View *b
+);
+
+static bool
+spec_ast_blocks_equal(
+  Mass_Context *context,
+  const Ast_Block *a,
+  const Ast_Block *b
+) {
+  tokenizer_ast_block_ensure_built(context, a);
+  tokenizer_ast_block_ensure_built(context, b);
+  const Ast_Statement *a_statement = a->first_statement;
+  const Ast_Statement *b_statement = b->first_statement;
+  for (; a_statement && b_statement; a_statement = a_statement->next, b_statement = b_statement->next) {
+    if (!spec_value_views_equal(context, &a_statement->children, &b_statement->children)) return false;
+  }
+  return !a_statement && !b_statement;
+}
+
+static bool
+spec_tokens_equal(
+  Mass_Context *context,
+  Value *a,
+  Value *b
+) {
+  if (a->descriptor != b->descriptor) return false;
+  if (a->source_range.file != b->source_range.file) return false;
+  if (!range_equal(a->source_range.offsets, b->source_range.offsets)) return false;
+  if (value_is_symbol(a)) return value_as_symbol(a) == value_as_symbol(b);
+  if (value_is_i64(a)) return value_as_i64(a)->bits == value_as_i64(b)->bits;
+  if (value_is_slice(a)) return slice_equal(*value_as_slice(a), *value_as_slice(b));
+  if (value_is_group_paren(a)) {
+    return spec_value_views_equal(context, &value_as_group_paren(a)->children, &value_as_group_paren(b)->children);
+  }
+  if (value_is_group_square(a)) {
+    return spec_value_views_equal(context, &value_as_group_square(a)->children, &value_as_group_square(b)->children);
+  }
+  if (value_is_ast_block(a)) return spec_ast_blocks_equal(context, value_as_ast_block(a), value_as_ast_block(b));
+  return false;
+}
+
+static bool
+spec_value_views_equal(
+  Mass_Context *context,
+  const Value_View *a,
+  const Value_View *b
+) {
+  if (a->length != b->length) return false;
+  if (!range_equal(a->source_range.offsets, b->source_range.offsets)) return false;
+  for (u32 i = 0; i < a->length; ++i) {
+    if (!spec_tokens_equal(context, value_view_get(a, i), value_view_get(b, i))) return false;
+  }
+  return true;
+}
+
+static bool
+spec_tokenize_results_equal(
+  Mass_Context *context,
+  const Mass_Result *expected_result,
+  const Ast_Block *expected,
+  const Mass_Result *actual_result,
+  const Ast_Block *actual
+) {
+  if (actual_result->tag != expected_result->tag) return false;
+  if (actual_result->tag == Mass_Result_Tag_Success) return spec_ast_blocks_equal(context, expected, actual);
+  return range_equal(
+    actual_result->Error.error.source_range.offsets,
+    expected_result->Error.error.source_range.offsets
+  );
+}
+
+static bool
+spec_tokenize_same_in_all_scan_modes(
+  Mass_Context *context,
+  Source_Range source_range,
+  Mass_Result_Tag expected_tag
+) {
+  Tokenizer_Scan_Mode original_mode = tokenizer_scan_mode;
+  tokenizer_scan_mode = Tokenizer_Scan_Mode_Scalar;
+  Ast_Block expected;
+  Mass_Result expected_result = tokenize(context, source_range, &expected);
+  // Otherwise a broken fixture would only compare matching errors
+  if (expected_result.tag != expected_tag) {
+    tokenizer_scan_mode = original_mode;
+    return false;
+  }
+
+  Tokenizer_Scan_Mode simd_modes[2];
+  u64 simd_mode_count = 0;
+  #ifdef PRELUDE_X86_64
+  simd_modes[simd_mode_count++] = Tokenizer_Scan_Mode_Sse2;
+  if (system_cpu_supports_avx2()) simd_modes[simd_mode_count++] = Tokenizer_Scan_Mode_Avx2;
+  #endif
+
+  bool success = true;
+  for (u64 i = 0; i < simd_mode_count && success; ++i) {
+    tokenizer_scan_mode = simd_modes[i];
+    Ast_Block actual;
+    Mass_Result result = tokenize(context, source_range, &actual);
+    success = spec_tokenize_results_equal(context, &expected_result, &expected, &result, &actual);
+  }
+  tokenizer_scan_mode = original_mode;
+  return success;
+}
+
+static bool
+spec_tokenize_same_serial_and_parallel(
+  Mass_Context *context,
+  Source_Range source_range,
+  Mass_Result_Tag expected_tag
+) {
+  u64 original_min_byte_size = tokenizer_parallel_min_byte_size;
+  u64 original_chunk_byte_size = tokenizer_parallel_chunk_byte_size;
+  u64 original_max_worker_count = tokenizer_parallel_max_worker_count;
+
+  tokenizer_parallel_min_byte_size = UINT64_MAX;
+  Ast_Block expected;
+  Mass_Result expected_result = tokenize(context, source_range, &expected);
+  tokenizer_parallel_min_byte_size = original_min_byte_size;
+  if (expected_result.tag != expected_tag) return false;
+
+  // A chunk size of 1 splits at every possible statement boundary
+  u64 chunk_byte_sizes[] = {1, 64, 4096};
+  // Forcing the worker count runs the threads even on a single core machine
+  u64 worker_counts[] = {2, 4};
+  tokenizer_parallel_min_byte_size = 0;
+  bool success = true;
+  for (u64 i = 0; i < countof(chunk_byte_sizes) && success; ++i) {
+    for (u64 j = 0; j < countof(worker_counts) && success; ++j) {
+      tokenizer_parallel_chunk_byte_size = chunk_byte_sizes[i];
+      tokenizer_parallel_max_worker_count = worker_counts[j];
+      Ast_Block actual;
+      Mass_Result result = tokenize(context, source_range, &actual);
+      success = spec_tokenize_results_equal(context, &expected_result, &expected, &result, &actual);
+    }
+  }
+
+  tokenizer_parallel_min_byte_size = original_min_byte_size;
+  tokenizer_parallel_chunk_byte_size = original_chunk_byte_size;
+  tokenizer_parallel_max_worker_count = original_max_worker_count;
+  return success;
+}
+
 static inline Value *
 test_program_source_base(
   const char *id,
@@ -213,6 +366,107 @@ spec("source") {
     compilation_deinit(&test_compilation);
   }
 
+  describe("Hash Map") {
+    it("should keep all entries reachable while growing") {
+      Spec_Pointer_Map *map = hash_map_make(Spec_Pointer_Map, .initial_capacity = 1);
+      check(map->capacity == HASH_MAP_GROUP_WIDTH);
+      const u64 count = 10000;
+      for (u64 i = 1; i <= count; ++i) {
+        hash_map_set(map, (const void *)(i * 8), i);
+      }
+      check(map->occupied == count);
+      check(map->capacity > count);
+      for (u64 i = 1; i <= count; ++i) {
+        u64 *value = hash_map_get(map, (const void *)(i * 8));
+        check(value && *value == i);
+      }
+      check(!hash_map_has(map, (const void *)((count + 1) * 8)));
+      hash_map_destroy(map);
+    }
+
+    it("should overwrite the value when setting an existing key") {
+      Spec_Pointer_Map *map = hash_map_make(Spec_Pointer_Map);
+      hash_map_set(map, (const void *)16, 1);
+      hash_map_set(map, (const void *)16, 2);
+      check(map->occupied == 1);
+      check(*hash_map_get(map, (const void *)16) == 2);
+      hash_map_destroy(map);
+    }
+
+    it("should not find deleted keys but still find keys probed past them") {
+      Spec_Pointer_Map *map = hash_map_make(Spec_Pointer_Map);
+      const u64 count = 100;
+      for (u64 i = 1; i <= count; ++i) {
+        hash_map_set(map, (const void *)(i * 8), i);
+      }
+      for (u64 i = 1; i <= count; i += 2) {
+        hash_map_delete(map, (const void *)(i * 8));
+      }
+      check(map->occupied == count / 2);
+      for (u64 i = 1; i <= count; ++i) {
+        u64 *value = hash_map_get(map, (const void *)(i * 8));
+        if (i % 2) {
+          check(!value);
+        } else {
+          check(value && *value == i);
+        }
+      }
+      hash_map_destroy(map);
+    }
+
+    it("should reuse dead slots instead of growing when keys keep being replaced") {
+      Spec_Pointer_Map *map = hash_map_make(Spec_Pointer_Map, .initial_capacity = 64);
+      for (u64 i = 1; i <= 100000; ++i) {
+        hash_map_set(map, (const void *)(i * 8), i);
+        if (i > 20) hash_map_delete(map, (const void *)((i - 20) * 8));
+      }
+      check(map->occupied == 20);
+      check(map->capacity == 64);
+      check(map->occupied + map->tombstones <= hash_map_max_load(map->capacity));
+      hash_map_destroy(map);
+    }
+
+    it("should shrink to fit the remaining entries") {
+      Spec_Pointer_Map *map = hash_map_make(Spec_Pointer_Map);
+      for (u64 i = 1; i <= 1000; ++i) {
+        hash_map_set(map, (const void *)(i * 8), i);
+      }
+      for (u64 i = 11; i <= 1000; ++i) {
+        hash_map_delete(map, (const void *)(i * 8));
+      }
+      hash_map_shrink_to_fit(map);
+      check(map->capacity == HASH_MAP_GROUP_WIDTH);
+      check(map->tombstones == 0);
+      for (u64 i = 1; i <= 10; ++i) {
+        u64 *value = hash_map_get(map, (const void *)(i * 8));
+        check(value && *value == i);
+      }
+      hash_map_destroy(map);
+    }
+
+    it("should only visit live entries when iterating") {
+      Spec_Pointer_Map *map = hash_map_make(Spec_Pointer_Map);
+      u64 expected_sum = 0;
+      for (u64 i = 1; i <= 200; ++i) {
+        hash_map_set(map, (const void *)(i * 8), i);
+        if (i % 3) expected_sum += i;
+      }
+      for (u64 i = 3; i <= 200; i += 3) {
+        hash_map_delete(map, (const void *)(i * 8));
+      }
+      u64 count = 0;
+      u64 sum = 0;
+      HASH_MAP_FOREACH(Spec_Pointer_Map__Entry, entry, map) {
+        count += 1;
+        sum += entry->value;
+        check((u64)entry->key == entry->value * 8);
+      }
+      check(count == map->occupied);
+      check(sum == expected_sum);
+      hash_map_destroy(map);
+    }
+  }
+
   describe("Scope") {
     it("should be able to set and lookup values") {
       Value *test = value_init(
@@ -253,6 +507,165 @@ spec("source") {
       Scope_Entry *entry = scope_lookup(scope_level_2, global_symbol);
       check(entry->value == global);
     }
+
+    it("should find all definitions as a scope grows through its layouts") {
+      Scope *flat_scope = scope_make_declarative(test_context.allocator, 0);
+      Scope *indexed_scope = scope_make_declarative_indexed(test_context.allocator, 0);
+      const Symbol *symbols[40];
+      Value *values[countof(symbols)];
+      for (u64 i = 0; i < countof(symbols); ++i) {
+        char name[16];
+        snprintf(name, countof(name), "symbol_%" PRIu64, i);
+        Slice name_slice = slice_from_c_string(name);
+        char *bytes = allocator_allocate_bytes(test_context.allocator, name_slice.length, 1);
+        memcpy(bytes, name_slice.bytes, name_slice.length);
+        symbols[i] = mass_ensure_symbol(&test_compilation, (Slice){bytes, name_slice.length});
+        values[i] = value_init(
+          allocator_allocate(test_context.allocator, Value),
+          &descriptor_i64, imm64(i), (Source_Range){0}
+        );
+        scope_define_value(flat_scope, (Epoch){0}, (Source_Range){0}, symbols[i], values[i]);
+        scope_define_value(indexed_scope, (Epoch){0}, (Source_Range){0}, symbols[i], values[i]);
+        if (i < SCOPE_FLAT_MAX_CAPACITY) {
+          check(flat_scope->Declarative.layout == Declarative_Scope_Layout_Flat);
+        }
+      }
+      check(flat_scope->Declarative.layout == Declarative_Scope_Layout_Map);
+      check(indexed_scope->Declarative.layout == Declarative_Scope_Layout_Direct);
+      for (u64 i = 0; i < countof(symbols); ++i) {
+        check(scope_lookup_shallow(flat_scope, symbols[i])->value == values[i]);
+        check(scope_lookup_shallow(indexed_scope, symbols[i])->value == values[i]);
+      }
+      const Symbol *missing = mass_ensure_symbol(&test_compilation, slice_literal("missing"));
+      check(!scope_lookup_shallow(flat_scope, missing));
+      check(!scope_lookup_shallow(indexed_scope, missing));
+
+      u64 count = 0;
+      u64 cursor = 0;
+      for (Scope_Entry *entry; (entry = scope_declarative_next_entry(indexed_scope, &cursor));) {
+        count += 1;
+      }
+      check(count == countof(symbols));
+    }
+
+    it("should only keep a direct table for indexed module scopes while it stays dense") {
+      Scope *root_scope = test_context.compilation->root_scope;
+      const Scope *compiler_scope = test_context.compilation->compiler_module.own_scope;
+      check(compiler_scope->Declarative.layout == Declarative_Scope_Layout_Direct);
+      check(
+        compiler_scope->Declarative.capacity <=
+        2 * compiler_scope->Declarative.count * SCOPE_DIRECT_MAX_SPARSITY
+      );
+
+      // Symbols interned after the prelude has loaded have ids too sparse for a direct table
+      Scope *sparse_scope = scope_make_declarative_indexed(test_context.allocator, root_scope);
+      const Symbol *symbols[8];
+      for (u64 i = 0; i < countof(symbols); ++i) {
+        char name[16];
+        snprintf(name, countof(name), "sparse_%" PRIu64, i);
+        Slice name_slice = slice_from_c_string(name);
+        char *bytes = allocator_allocate_bytes(test_context.allocator, name_slice.length, 1);
+        memcpy(bytes, name_slice.bytes, name_slice.length);
+        symbols[i] = mass_ensure_symbol(&test_compilation, (Slice){bytes, name_slice.length});
+        Value *value = value_init(
+          allocator_allocate(test_context.allocator, Value),
+          &descriptor_i64, imm64(i), (Source_Range){0}
+        );
+        scope_define_value(sparse_scope, (Epoch){0}, (Source_Range){0}, symbols[i], value);
+      }
+      check(sparse_scope->Declarative.layout == Declarative_Scope_Layout_Map);
+      for (u64 i = 0; i < countof(symbols); ++i) {
+        check(value_as_i64(scope_lookup_shallow(sparse_scope, symbols[i])->value)->bits == i);
+      }
+    }
+
+    it("should invalidate cached lookups when an intermediate scope shadows a symbol") {
+      Compilation *compilation = test_context.compilation;
+      const Symbol *symbol = mass_ensure_symbol(compilation, slice_literal("cached_symbol"));
+      Value *outer = value_init(
+        allocator_allocate(test_context.allocator, Value),
+        &descriptor_i64, imm64(1), (Source_Range){0}
+      );
+      Value *inner = value_init(
+        allocator_allocate(test_context.allocator, Value),
+        &descriptor_i64, imm64(2), (Source_Range){0}
+      );
+      Scope *root_scope = scope_make_declarative(test_context.allocator, 0);
+      Scope *middle_scope = scope_make_declarative(test_context.allocator, root_scope);
+      Scope *leaf_scope = scope_make_declarative(test_context.allocator, middle_scope);
+      scope_define_value(root_scope, (Epoch){0}, (Source_Range){0}, symbol, outer);
+
+      check(mass_scope_lookup_cached(compilation, leaf_scope, symbol)->value == outer);
+      u64 hits = compilation->counters.scope_lookup_cache_hits;
+      check(mass_scope_lookup_cached(compilation, leaf_scope, symbol)->value == outer);
+      check(compilation->counters.scope_lookup_cache_hits == hits + 1);
+
+      scope_define_value(middle_scope, (Epoch){0}, (Source_Range){0}, symbol, inner);
+      check(mass_scope_lookup_cached(compilation, leaf_scope, symbol)->value == inner);
+      check(mass_scope_lookup_cached(compilation, root_scope, symbol)->value == outer);
+    }
+
+    it("should not let Mass code touch the lookup cache bookkeeping of a symbol") {
+      test_program_inline_source_base(
+        "main", &test_context,
+        "main :: fn(symbol : &MASS.Symbol) -> () { symbol.definition_count = 0 }"
+      );
+      check(test_context.result->tag == Mass_Result_Tag_Error);
+      Mass_Error *error = &test_context.result->Error.error;
+      check(error->tag == Mass_Error_Tag_Unknown_Field);
+      spec_check_slice(error->Unknown_Field.name, slice_literal("definition_count"));
+    }
+
+    it("should only see earlier locals through chunked imperative scopes") {
+      Scope *root_scope = scope_make_declarative(test_context.allocator, 0);
+      const Symbol *symbols[300];
+      Value *values[countof(symbols)];
+      Scope *scopes[countof(symbols)];
+      const Scope *scope = root_scope;
+      for (u64 i = 0; i < countof(symbols); ++i) {
+        char name[16];
+        // Every tenth local shadows an earlier one
+        snprintf(name, countof(name), "local_%" PRIu64, i % 10 ? i : i / 10);
+        Slice name_slice = slice_from_c_string(name);
+        char *bytes = allocator_allocate_bytes(test_context.allocator, name_slice.length, 1);
+        memcpy(bytes, name_slice.bytes, name_slice.length);
+        symbols[i] = mass_ensure_symbol(&test_compilation, (Slice){bytes, name_slice.length});
+        values[i] = value_init(
+          allocator_allocate(test_context.allocator, Value),
+          &descriptor_i64, imm64(i), (Source_Range){0}
+        );
+        scope = scopes[i] = scope_make_imperative(test_context.allocator, scope, &(Scope_Entry) {
+          .value = values[i],
+          .symbol = symbols[i],
+          .name = symbols[i]->name,
+        });
+      }
+      // Consecutive locals share chunks so the parent chain stays short
+      u64 depth = 0;
+      for (const Scope *it = scope; it != root_scope; it = it->parent) depth += 1;
+      check(depth < 10);
+
+      for (u64 i = 0; i < countof(symbols); ++i) {
+        check(scope_lookup(scopes[i], symbols[i])->value == values[i]);
+        bool next_is_new = i + 1 < countof(symbols) && (i + 1) % 10;
+        if (next_is_new) check(!scope_lookup(scopes[i], symbols[i + 1]));
+      }
+      // `local_5` is defined at 5 and shadowed at 50
+      check(scope_lookup(scopes[49], symbols[50])->value == values[5]);
+      check(scope_lookup(scopes[299], symbols[5])->value == values[50]);
+
+      // Branching off an older snapshot must not affect scopes made after it
+      const Symbol *branch_symbol = mass_ensure_symbol(&test_compilation, slice_literal("branch_local"));
+      Scope *branch = scope_make_imperative(test_context.allocator, scopes[100], &(Scope_Entry) {
+        .value = values[0],
+        .symbol = branch_symbol,
+        .name = branch_symbol->name,
+      });
+      check(scope_lookup(branch, branch_symbol)->value == values[0]);
+      check(scope_lookup(branch, symbols[100])->value == values[100]);
+      check(!scope_lookup(branch, symbols[101]));
+      check(!scope_lookup(scopes[299], branch_symbol));
+    }
   }
 
   describe("Tokenizer") {
@@ -454,6 +867,8 @@ spec("source") {
       Value *block_value = value_view_get(&tokens, 0);
       check(value_is_ast_block(block_value));
       const Ast_Block *block = value_as_ast_block(block_value);
+      tokenizer_ast_block_ensure_built(&test_context, block);
+      check(block->first_statement);
       check(block->first_statement == block->last_statement);
       spec_check_slice(source_from_source_range(test_context.compilation, &block_value->source_range), slice_literal("{[]}"));
 
@@ -463,6 +878,49 @@ spec("source") {
       spec_check_slice(source_from_source_range(test_context.compilation, &square->source_range), slice_literal("[]"));
     }
 
+    it("should only build nested blocks when they are needed") {
+      Source_Range source_range = test_inline_source_range(test_context.compilation, "f :: { a\n{ b; c } }");
+      Ast_Block root;
+      Mass_Result result = tokenize(&test_context, source_range, &root);
+      check(result.tag == Mass_Result_Tag_Success);
+      check(root.first_statement == root.last_statement);
+      Value_View tokens = root.first_statement->children;
+      check(tokens.length == 3);
+
+      Value *outer_value = value_view_get(&tokens, 2);
+      check(value_is_ast_block(outer_value));
+      spec_check_slice(source_from_source_range(test_context.compilation, &outer_value->source_range), slice_literal("{ a\n{ b; c } }"));
+      const Ast_Block *outer = value_as_ast_block(outer_value);
+      check(outer->lazy_stream);
+      check(!outer->first_statement);
+
+      tokenizer_ast_block_ensure_built(&test_context, outer);
+      check(!outer->lazy_stream);
+      check(outer->first_statement);
+      check(outer->first_statement->next == outer->last_statement);
+      Value *inner_value = value_view_get(&outer->last_statement->children, 0);
+      check(value_is_ast_block(inner_value));
+      const Ast_Block *inner = value_as_ast_block(inner_value);
+      check(inner->lazy_stream);
+
+      tokenizer_ast_block_ensure_built(&test_context, inner);
+      check(inner->first_statement);
+      check(inner->first_statement->next == inner->last_statement);
+      Value *c = value_view_get(&inner->last_statement->children, 0);
+      check(value_as_symbol(c) == mass_ensure_symbol(test_context.compilation, slice_literal("c")));
+    }
+
+    it("should not expose lazily built blocks to Mass code") {
+      test_program_inline_source_base(
+        "main", &test_context,
+        "main :: fn(block : MASS.Ast_Block) -> () {}"
+      );
+      check(test_context.result->tag == Mass_Result_Tag_Error);
+      Mass_Error *error = &test_context.result->Error.error;
+      check(error->tag == Mass_Error_Tag_Unknown_Field);
+      spec_check_slice(error->Unknown_Field.name, slice_literal("Ast_Block"));
+    }
+
     it("should be able to tokenize complex input") {
       Source_Range source_range = test_inline_source_range(
         test_context.compilation,
@@ -500,6 +958,126 @@ spec("source") {
       check(error->source_range.offsets.from == 4);
       check(error->source_range.offsets.to == 4);
     }
+
+    it("should produce identical tokens with scalar and SIMD scanning of long runs") {
+      Source_Range source_range = test_inline_source_range(
+        test_context.compilation,
+        "a_very_long_identifier_that_does_not_fit_into_a_single_vector_register :: 42\n"
+        "                                          \t\t\t\t   x\n"
+        "// a comment that is long enough to span more than thirty two bytes of input\r\n"
+        "y := 1_000_000_000_000_000 + 0xDEAD_BEEF_cafe_F00D + 0b1010_1010_1010_1010_1010_1010\n"
+        "z := \"a string that also spans a couple of vector widths with \\\"escapes\\\" \\n\"\n"
+        "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+        "f :: fn(argument_number_one : i64, argument_number_two : i64) -> (i64) {\n"
+        "  argument_number_one + argument_number_two // trailing comment\n"
+        "}\n"
+        "0o777_777 1234567890_1234567890_1234567890_1234567890 q // trailing comment without a newline"
+      );
+      check(spec_tokenize_same_in_all_scan_modes(&test_context, source_range, Mass_Result_Tag_Success));
+    }
+
+    it("should report the same error with scalar and SIMD scanning of an unterminated string") {
+      Source_Range source_range = test_inline_source_range(
+        test_context.compilation,
+        "foo := \"this string goes on and on and on and never finds its closing quote"
+      );
+      check(spec_tokenize_same_in_all_scan_modes(&test_context, source_range, Mass_Result_Tag_Error));
+    }
+
+    it("should produce identical tokens with scalar and SIMD scanning of std/prelude") {
+      Fixed_Buffer *buffer = fixed_buffer_from_file(slice_literal("std/prelude.mass"));
+      check(buffer);
+      Source_File file = { .path = slice_literal("std/prelude.mass"), .text = fixed_buffer_as_slice(buffer) };
+      Source_Range source_range = {
+        .file = &file,
+        .offsets = {.from = 0, .to = u64_to_u32(buffer->occupied)},
+      };
+      check(spec_tokenize_same_in_all_scan_modes(&test_context, source_range, Mass_Result_Tag_Success));
+      fixed_buffer_destroy(buffer);
+    }
+
+    it("should split input into chunks only at top-level statement boundaries") {
+      Source_Range source_range = test_inline_source_range(
+        test_context.compilation,
+        "a := (1\n2); b := \"\\\";\n\"\n"
+        "// c; d\r\n\n"
+        "e := { f\n g }\n"
+        "h"
+      );
+      Array_Tokenizer_Chunk chunks = tokenizer_split_into_chunks(
+        test_context.temp_allocator, tokenizer_scan_mode_detect(),
+        source_range.file->text, source_range.offsets, 1
+      );
+      Slice text = source_range.file->text;
+      Slice expected_chunks[] = {
+        slice_literal("a := (1\n2);"),
+        slice_literal(" b := \"\\\";\n\"\n"),
+        slice_literal("// c; d\r\n\n"),
+        slice_literal("e := { f\n g }\n"),
+        slice_literal("h"),
+      };
+      check(dyn_array_length(chunks) == countof(expected_chunks));
+      for (u64 i = 0; i < countof(expected_chunks); ++i) {
+        Range_u32 offsets = dyn_array_get(chunks, i)->offsets;
+        check(slice_equal(slice_sub(text, offsets.from, offsets.to), expected_chunks[i]));
+      }
+    }
+
+    it("should produce identical tokens with serial and parallel tokenization") {
+      Source_Range source_range = test_inline_source_range(
+        test_context.compilation,
+        "a :: 42; b :: \"string with ; and \\\" and \n inside\"\n\n"
+        "// a comment with ; and ( inside\r\n"
+        "f :: fn(x : i64) -> (i64) {\n  x + 1\n}\n"
+        "arr := [1, 2,\n 3]\n"
+        "0x_FF 0b1010 0o777;;;\n\n\n"
+        "last_statement_without_newline"
+      );
+      check(spec_tokenize_same_serial_and_parallel(&test_context, source_range, Mass_Result_Tag_Success));
+    }
+
+    it("should report the same error with serial and parallel tokenization") {
+      const char *sources[] = {
+        "a := 1\nb := (2\nc := 3\n",
+        "a := 1\nb := 2)\nc := 0777\n",
+        "a := 1\nb := 0777\nc := 2)\n",
+        "a := 1\nb := \"unterminated\nc := 2\n",
+      };
+      for (u64 i = 0; i < countof(sources); ++i) {
+        Source_Range source_range = test_inline_source_range(test_context.compilation, sources[i]);
+        check(spec_tokenize_same_serial_and_parallel(&test_context, source_range, Mass_Result_Tag_Error));
+      }
+    }
+
+    it("should produce identical tokens with serial and parallel tokenization of std/prelude") {
+      Fixed_Buffer *buffer = fixed_buffer_from_file(slice_literal("std/prelude.mass"));
+      check(buffer);
+      Source_File file = { .path = slice_literal("std/prelude.mass"), .text = fixed_buffer_as_slice(buffer) };
+      Source_Range source_range = {
+        .file = &file,
+        .offsets = {.from = 0, .to = u64_to_u32(buffer->occupied)},
+      };
+      check(spec_tokenize_same_serial_and_parallel(&test_context, source_range, Mass_Result_Tag_Success));
+      fixed_buffer_destroy(buffer);
+    }
+
+    it("should map source offsets to a line and a column") {
+      Source_Range source_range = test_inline_source_range(test_context.compilation, "ab\n\ncd\nef");
+      struct { u32 offset; u64 line; u64 column; } cases[] = {
+        {0, 1, 0}, {1, 1, 1}, {2, 1, 2},
+        {3, 2, 0},
+        {4, 3, 0}, {6, 3, 2},
+        {7, 4, 0}, {9, 4, 2},
+      };
+      for (u64 i = 0; i < countof(cases); ++i) {
+        Source_Range range = source_range;
+        range.offsets.from = cases[i].offset;
+        Source_Position position = source_range_to_line_column(test_context.compilation, &range);
+        check(position.line == cases[i].line);
+        check(position.column == cases[i].column);
+      }
+      check(source_range.file->line_count == 4);
+    }
   }
 
   describe("if / else") {
@@ -798,6 +1376,42 @@ spec("source") {
       check(size == 4);
     }
 
+    it("should reuse overload matches for repeated calls with the same argument types") {
+      u64 hits = test_context.compilation->counters.overload_match_cache_hits;
+      s64(*checker)(s32, s64) = (s64(*)(s32, s64))test_program_inline_source_function(
+        "checker", &test_context,
+        "my_size_of :: fn(x : s32) -> (s64) { 4 }\n"
+        "my_size_of :: fn(x : s64) -> (s64) { 8 }\n"
+        "pick :: fn(x :: 1) -> (s64) { 10 }\n"
+        "pick :: fn(x :: 2) -> (s64) { 20 }\n"
+        "checker :: fn(x : s32, y : s64) -> (s64) {\n"
+          "my_size_of(x) + my_size_of(y) + my_size_of(x) + my_size_of(y) + pick(1) + pick(2) + pick(1)\n"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.overload_match_cache_hits > hits);
+      s64 actual = checker(0, 0);
+      check(actual == 64);
+    }
+
+    it("should select overloads by argument count, defaults and the first argument type") {
+      s64(*checker)(s32, s64) = (s64(*)(s32, s64))test_program_inline_source_function(
+        "checker", &test_context,
+        "pick :: fn(x : s32) -> (s64) { 1 }\n"
+        "pick :: fn(x : s64) -> (s64) { 2 }\n"
+        "pick :: fn(x : s32, y : s64, z : s64 = 0) -> (s64) { 30 + z }\n"
+        "pick :: fn(x : s64, y : s64) -> (s64) { 40 }\n"
+        "pick :: fn(x :: 7) -> (s64) { 500 }\n"
+        "pick_alias :: pick\n"
+        "checker :: fn(x : s32, y : s64) -> (s64) {\n"
+          "pick(x) + pick(y) + pick(x, y) + pick(x, y, 100) + pick(y, y) + pick_alias(7)\n"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      s64 actual = checker(0, 0);
+      check(actual == 1 + 2 + 30 + 130 + 40 + 500);
+    }
+
     // TODO support either
     //  * lookup in parents and merging in of that overload set
     //  * some way to manually merge it in via smth like
@@ -1094,6 +1708,24 @@ spec("source") {
       checker();
     }
 
+    it("should pass scalar arguments to compile-time functions in registers") {
+      u64 direct = test_context.compilation->counters.trampoline_direct_call_count;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "identity :: fn(x : s8) => (s8) { x }\n"
+        "combine :: fn(a : s64, b : s64, c : s64, d : s64, e : s64, f : s64) => (s64) {\n"
+          "a * 100000 + b * 10000 + c * 1000 + d * 100 + e * 10 + f\n"
+        "}\n"
+        "checker :: fn() -> (s64) {\n"
+          "small :: identity(cast(s8, -3))\n"
+          "if small == cast(s8, -3) then combine(1, 2, 3, 4, 5, 6) else 0\n"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.trampoline_direct_call_count >= direct + 2);
+      check(checker() == 123456);
+    }
+
     it("should prefer a compile-time overload over a runtime if args are compile-time known") {
       u64(*checker)(void) = (u64(*)(void))test_program_inline_source_function(
         "checker", &test_context,
@@ -1140,6 +1772,42 @@ spec("source") {
       check(checker() == 42);
     }
 
+    it("should reuse generic specializations and instances for the same argument types") {
+      s64(*checker)(s32, s64) = (s64(*)(s32, s64))test_program_inline_source_function(
+        "checker", &test_context,
+        "my_identity :: fn(x) -> (x) { x }\n"
+        "checker :: fn(a : s32, b : s64) -> (s64) {\n"
+          "my_identity(a)\n"
+          "my_identity(a)\n"
+          "my_identity(b) + my_identity(b)\n"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(checker(1, 21) == 42);
+      const Symbol *symbol = mass_ensure_symbol(test_context.compilation, slice_literal("my_identity"));
+      Value *value = scope_lookup(test_context.compilation->root_scope, symbol)->value;
+      const Function_Literal *literal = value_as_function_literal(value);
+      check(dyn_array_length(literal->specializations) == 2);
+      check(dyn_array_length(literal->instances) == 2);
+    }
+
+    it("should keep separate instances of a literal for runtime and compile-time use") {
+      Compilation *compilation = test_context.compilation;
+      u64 instance_count = compilation->counters.function_instance_count;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "double :: fn(x : s64) -> (s64) { x + x }\n"
+        "checker :: fn() -> (s64) { double(double(5)) + double(@(double(1))) }\n"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(checker() == 24);
+      const Symbol *symbol = mass_ensure_symbol(compilation, slice_literal("double"));
+      Value *value = scope_lookup(compilation->root_scope, symbol)->value;
+      const Function_Literal *literal = value_as_function_literal(value);
+      check(dyn_array_length(literal->instances) == 2);
+      check(compilation->counters.function_instance_count >= instance_count + 2);
+    }
+
     it("should be able to accept a function as an argument and call it") {
       u64(*checker)(Spec_Callback foo) =
         (u64(*)(Spec_Callback))test_program_inline_source_function(
@@ -1642,6 +2310,18 @@ spec("source") {
   }
 
   describe("Operators") {
+    it("should only mark symbols declared as operators with their fixities") {
+      Compilation *compilation = test_context.compilation;
+      const Symbol *plus = mass_ensure_symbol(compilation, slice_literal("+"));
+      check(symbol_interned(plus)->operator_fixities & Operator_Fixity_Infix);
+      const Symbol *minus = mass_ensure_symbol(compilation, slice_literal("-"));
+      check(symbol_interned(minus)->operator_fixities & Operator_Fixity_Infix);
+      check(symbol_interned(minus)->operator_fixities & Operator_Fixity_Prefix);
+      const Symbol *plain = mass_ensure_symbol(compilation, slice_literal("not_an_operator"));
+      check(symbol_interned(plain)->operator_fixities == 0);
+      check(!scope_lookup_operator(&test_context, compilation->root_scope, plain, Operator_Fixity_Prefix));
+    }
+
     it("should be able to parse and run a triple plus function") {
       s64(*checker)(s64, s64, s64) = (s64(*)(s64, s64, s64))test_program_inline_source_function(
         "plus", &test_context,
@@ -1816,6 +2496,120 @@ spec("source") {
       check(error->tag == Mass_Error_Tag_Epoch_Mismatch);
     }
 
+    it("should reuse the result of a compile-time evaluation with the same static inputs") {
+      u64 hits = test_context.compilation->counters.compile_time_eval_cache_hits;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "double :: fn(x : s64) -> (s64) { x + x }\n"
+        "wrap :: fn(x) -> (s64) { @(double(21)) }\n"
+        "checker :: fn() -> (s64) { wrap(1) + wrap(cast(s32, 1)) }"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.compile_time_eval_cache_hits == hits + 1);
+      check(checker() == 84);
+    }
+
+    it("should interpret simple compile-time arithmetic without generating code") {
+      u64 interpreted = test_context.compilation->counters.compile_time_eval_interpreted_count;
+      u64 jitted = test_context.compilation->counters.compile_time_eval_jit_count;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "X :: cast(s64, -7)\n"
+        "Y :: cast(s64, 3)\n"
+        "Z :: cast(u8, 250)\n"
+        "checker :: fn() -> (s64) {\n"
+        "  div_result :: @(X / Y)\n"
+        "  rem_result :: @(X % Y)\n"
+        "  wrapped :: @(zero_extend(s64, Z + cast(u8, 10)))\n"
+        "  y_is_less :: @(Y < X)\n"
+        "  if y_is_less then 0 else div_result * 100 + rem_result * 10 + wrapped\n"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.compile_time_eval_interpreted_count == interpreted + 4);
+      check(test_context.compilation->counters.compile_time_eval_jit_count == jitted);
+      check(checker() == -2 * 100 + -1 * 10 + 4);
+    }
+
+    it("should interpret unsigned compares, narrowing casts and field reads like the JIT") {
+      u64 interpreted = test_context.compilation->counters.compile_time_eval_interpreted_count;
+      u64 jitted = test_context.compilation->counters.compile_time_eval_jit_count;
+      // Casts and field reads of static values are folded while parsing, so the operands
+      // go through an addition to reach the interpreter. PACKED is `Point [18, 22]`.
+      s32(*checker)(void) = (s32(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "Point :: c_struct [x : s32, y : s32]\n"
+        "PACKED :: cast(s64, 94489280530)\n"
+        "WIDE :: cast(s64, 100)\n"
+        "is_greater :: fn(a : u8, b : u8) -> (bool) { a > b }\n"
+        "narrow :: fn(x : s64) -> (s8) { cast(s8, x) }\n"
+        "point_y :: fn(p : Point) -> (s32) { p.y }\n"
+        "checker :: fn() -> (s32) {\n"
+        "  interpreted_greater :: @(cast(u8, 200) > cast(u8, 100))\n"
+        "  interpreted_narrow :: @(cast(s8, WIDE + cast(s64, 100)))\n"
+        "  interpreted_y :: @(cast(Point, PACKED + cast(s64, 2)).y)\n"
+        "  jit_greater :: @(is_greater(cast(u8, 200), cast(u8, 100)))\n"
+        "  jit_narrow :: @(narrow(WIDE + cast(s64, 100)))\n"
+        "  jit_y :: @(point_y(cast(Point, PACKED + cast(s64, 2))))\n"
+        "  if interpreted_greater != jit_greater then -1 else "
+        "  if interpreted_narrow != jit_narrow then -2 else "
+        "  if interpreted_y != jit_y then -3 else "
+        "  if interpreted_greater == false then -4 else "
+        "  if interpreted_narrow != cast(s8, -56) then -5 else "
+        "  interpreted_y\n"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.compile_time_eval_interpreted_count == interpreted + 3);
+      check(test_context.compilation->counters.compile_time_eval_jit_count == jitted + 3);
+      check(checker() == 22);
+    }
+
+    it("should always run compile-time evaluations marked as having side effects") {
+      u64 hits = test_context.compilation->counters.compile_time_eval_cache_hits;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "double :: fn(x : s64) -> (s64) { x + x }\n"
+        "wrap :: fn(x) -> (s64) { @!(double(21)) }\n"
+        "checker :: fn() -> (s64) { wrap(1) + wrap(cast(s32, 1)) }"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.compile_time_eval_cache_hits == hits);
+      check(checker() == 84);
+    }
+
+    #if defined(__linux__)
+    it("should run jitted code from a separate mapping than the one it is written to") {
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "double :: fn(x : s64) -> (s64) { x + x }\n"
+        "checker :: fn() -> (s64) { @(double(21)) }"
+      );
+      check(spec_check_mass_result(test_context.result));
+      const Program_Memory *memory = &test_context.compilation->jit.program->memory;
+      check(memory->code.execution_offset != 0);
+      // The writable view stays writable, so nothing has to be re-protected for the next JIT
+      memory->code.buffer.memory[memory->code.buffer.occupied] = 0;
+      check(checker() == 42);
+    }
+
+    it("should reclaim the code of compile-time evaluation thunks after running them") {
+      u64 reclaimed = test_context.compilation->counters.jit_reclaimed_thunk_count;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "double :: fn(x : s64) -> (s64) { x + x }\n"
+        "checker :: fn() -> (s64) { @!(double(20)) + @!(double(1)) }"
+      );
+      check(spec_check_mass_result(test_context.result));
+      const Jit *jit = &test_context.compilation->jit;
+      check(test_context.compilation->counters.jit_reclaimed_thunk_count == reclaimed + 2);
+      check(jit->thunk_buffer.occupied == jit->thunk_buffer_floor);
+      const Function_Builder *last = dyn_array_last(jit->program->functions);
+      check(last && !slice_equal(last->code_block.start_label->name, slice_literal("compile_time_eval")));
+      check(checker() == 42);
+    }
+    #endif
+
     it("should support compile-time arithmetic operations") {
       u64(*checker)() = (u64(*)())test_program_inline_source_function(
         "checker", &test_context,
@@ -1936,6 +2730,31 @@ spec("source") {
       check(checker() == 42);
     }
 
+    it("should share a single descriptor between identical array types") {
+      Compilation *compilation = test_context.compilation;
+      const Descriptor *a = descriptor_array_of(compilation, &descriptor_i64, 4);
+      const Descriptor *b = descriptor_array_of(compilation, &descriptor_i64, 4);
+      const Descriptor *c = descriptor_array_of(compilation, &descriptor_i64, 5);
+      check(a == b);
+      check(a != c);
+      check(same_type(a, b));
+
+      u64 hits = compilation->counters.descriptor_intern_hits;
+      u64(*checker)(void) = (u64(*)(void))test_program_inline_source_function(
+        "test", &test_context,
+        "test :: fn() -> (i64) {"
+          "foo : i64 * 4;"
+          "bar : i64 * 4;"
+          "bar.2 = 42;"
+          "foo = bar;"
+          "foo.2"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(compilation->counters.descriptor_intern_hits > hits);
+      check(checker() == 42);
+    }
+
     it("should be able to use a dynamic i64 variable to index an array") {
       u64(*checker)(void) = (u64(*)(void))test_program_inline_source_function(
         "test", &test_context,
@@ -2076,6 +2895,39 @@ spec("source") {
       check(checker() == 42);
     }
 
+    it("should be able to access fields of a struct with many fields by name") {
+      s32(*checker)(void) = (s32(*)(void))test_program_inline_source_function(
+        "test", &test_context,
+        "Wide :: c_struct [\n"
+          "a0 : s32, a1 : s32, a2 : s32, a3 : s32, a4 : s32, a5 : s32, a6 : s32, a7 : s32,\n"
+          "a8 : s32, a9 : s32, a10 : s32, a11 : s32, a12 : s32, a13 : s32, a14 : s32, a15 : s32,\n"
+          "a16 : s32, a17 : s32\n"
+        "]\n"
+        "test :: fn() -> (s32) {"
+          "w : Wide; w.a17 = 20; w.a3 = 1; w.a0 = 21;"
+          "w.a0 + w.a17 + w.a3"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(checker() == 42);
+    }
+
+    it("should report an unknown field of a struct with many fields") {
+      test_program_inline_source_function(
+        "test", &test_context,
+        "Wide :: c_struct [\n"
+          "a0 : s32, a1 : s32, a2 : s32, a3 : s32, a4 : s32, a5 : s32, a6 : s32, a7 : s32,\n"
+          "a8 : s32, a9 : s32, a10 : s32, a11 : s32, a12 : s32, a13 : s32, a14 : s32, a15 : s32,\n"
+          "a16 : s32, a17 : s32\n"
+        "]\n"
+        "test :: fn(w : Wide) -> (s32) { w.a18 };"
+      );
+      check(test_context.result->tag == Mass_Result_Tag_Error);
+      Mass_Error *error = &test_context.result->Error.error;
+      check(error->tag == Mass_Error_Tag_Unknown_Field);
+      check(slice_equal(error->Unknown_Field.name, slice_literal("a18")));
+    }
+
     it("should mark a field of a constant struct as a constant as well") {
       test_program_inline_source_function(
         "test", &test_context,
@@ -2099,6 +2951,24 @@ spec("source") {
       check(checker() == 42);
     }
 
+    it("should share a descriptor between unnamed tuple structs of the same shape") {
+      u64 hits = test_context.compilation->counters.descriptor_intern_hits;
+      s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
+        "test", &test_context,
+        "test :: fn() -> (s64) {"
+          "p := [20, 1]\n"
+          "q := [22, 2]\n"
+          "p = q\n"
+          "r := [.x = 20]\n"
+          "r = [.x = 20]\n"
+          "p.0 + r.x"
+        "}"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(test_context.compilation->counters.descriptor_intern_hits >= hits + 2);
+      check(checker() == 42);
+    }
+
     it("should be able to parse nested tuples and access their elements") {
       s64(*checker)(void) = (s64(*)(void))test_program_inline_source_function(
         "test", &test_context,
@@ -2675,6 +3545,24 @@ spec("source") {
       check(checker());
     }
 
+    it("should map imported module source without copying it") {
+      u64(*checker)(void) = (u64(*)(void))test_program_inline_source_function(
+        "checker", &test_context,
+        "sample_module :: import(\"fixtures/sample_module\")\n"
+        "checker :: fn() -> (i64) { sample_module.the_answer }"
+      );
+      check(spec_check_mass_result(test_context.result));
+      check(checker() == 42);
+      Fixed_Buffer *expected = fixed_buffer_from_file(slice_literal("fixtures/sample_module.mass"));
+      check(expected);
+      bool found = false;
+      DYN_ARRAY_FOREACH(File_Mapping, mapping, test_context.compilation->source_file_mappings) {
+        if (slice_equal(mapping->contents, fixed_buffer_as_slice(expected))) found = true;
+      }
+      check(found);
+      fixed_buffer_destroy(expected);
+    }
+
     it("should support inline modules") {
       u64(*checker)(void) = (u64(*)(void))test_program_inline_source_function(
         "checker", &test_context,
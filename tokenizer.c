@@ -10,20 +10,20 @@ typedef struct {
   Array_Value_Ptr token_stack;
   Array_Tokenizer_Parent parent_stack;
   const Source_File *source_file;
-  u64 token_start_offset;
   Mass_Result result;
 } Tokenizer_State;
 
 static inline Source_Range
 tokenizer_token_range(
   const Tokenizer_State *state,
-  u64 offset
+  u64 from,
+  u64 to
 ) {
   return (Source_Range){
     .file = state->source_file,
     .offsets = {
-      .from = u64_to_u32(state->token_start_offset),
-      .to = u64_to_u32(offset),
+      .from = u64_to_u32(from),
+      .to = u64_to_u32(to),
     }
   };
 }
@@ -126,7 +126,7 @@ tokenizer_group_start_curly(
 ) {
   Ast_Block *block = mass_allocate(context, Ast_Block);
   *block = (Ast_Block){0};
-  Source_Range source_range = tokenizer_token_range(state, offset);
+  Source_Range source_range = tokenizer_token_range(state, offset, offset);
   Value *value = value_make(context, &descriptor_ast_block, storage_static(block), source_range);
   tokenizer_group_push(state, value);
 }
@@ -138,7 +138,7 @@ tokenizer_group_start_paren(
   u64 offset
 ) {
   Group_Paren *group = mass_allocate(context, Group_Paren);
-  Source_Range source_range = tokenizer_token_range(state, offset);
+  Source_Range source_range = tokenizer_token_range(state, offset, offset);
   Value *value = value_make(context, &descriptor_group_paren, storage_static(group), source_range);
   tokenizer_group_push(state, value);
 }
@@ -150,7 +150,7 @@ tokenizer_group_start_square(
   u64 offset
 ) {
   Group_Square *group = mass_allocate(context, Group_Square);
-  Source_Range source_range = tokenizer_token_range(state, offset);
+  Source_Range source_range = tokenizer_token_range(state, offset, offset);
   Value *value = value_make(context, &descriptor_group_square, storage_static(group), source_range);
   tokenizer_group_push(state, value);
 }
@@ -287,196 +287,472 @@ tokenizer_handle_error(
   };
 }
 
-static PRELUDE_NO_DISCARD Mass_Result
-tokenize(
-  Mass_Context *context,
-  Source_Range source_range,
-  Ast_Block *out_block
+typedef enum {
+  Tokenizer_Scan_Mode_Auto,
+  Tokenizer_Scan_Mode_Scalar,
+  Tokenizer_Scan_Mode_Sse2,
+  Tokenizer_Scan_Mode_Avx2,
+} Tokenizer_Scan_Mode;
+
+// Can be overridden (mostly for testing) to force a particular implementation.
+// `Auto` picks the widest one supported by the CPU on the first `tokenize` call.
+static Tokenizer_Scan_Mode tokenizer_scan_mode = Tokenizer_Scan_Mode_Auto;
+
+static Tokenizer_Scan_Mode
+tokenizer_scan_mode_detect() {
+  #ifdef PRELUDE_X86_64
+  if (system_cpu_supports_avx2()) return Tokenizer_Scan_Mode_Avx2;
+  return Tokenizer_Scan_Mode_Sse2; // Always available on x86_64
+  #else
+  return Tokenizer_Scan_Mode_Scalar;
+  #endif
+}
+
+// Runs of bytes that the tokenizer would otherwise step through one at a time.
+// Each one must exactly match the set of bytes accepted by a continuation mask.
+typedef enum {
+  Tokenizer_Run_None,
+  Tokenizer_Run_Space,      // ' ', '\t'
+  Tokenizer_Run_Newline,    // '\r', '\n'
+  Tokenizer_Run_Identifier, // [0-9a-zA-Z_]
+  Tokenizer_Run_Binary,     // [01_]
+  Tokenizer_Run_Octal,      // [0-7_]
+  Tokenizer_Run_Decimal,    // [0-9_]
+  Tokenizer_Run_Hex,        // [0-9a-fA-F_]
+  Tokenizer_Run_Comment,    // anything except '\r' and '\n'
+  Tokenizer_Run_String,     // anything except '"'
+} Tokenizer_Run;
+
+static inline bool
+tokenizer_run_contains(
+  Tokenizer_Run run,
+  u8 byte
 ) {
-  Slice input = source_range.file->text;
-  Temp_Mark temp_mark = context_temp_mark(context);
-  Tokenizer_State state = {
-    .token_stack = dyn_array_make(
-      Array_Value_Ptr, .allocator = context->temp_allocator, .capacity = 100
-    ),
-    .parent_stack = dyn_array_make(
-      Array_Tokenizer_Parent, .allocator = context->temp_allocator, .capacity = 32
-    ),
-    .source_file = source_range.file,
-    .token_start_offset = source_range.offsets.from,
-    .result = {.tag = Mass_Result_Tag_Success},
-  };
+  switch(run) {
+    case Tokenizer_Run_None: return false;
+    case Tokenizer_Run_Space: return byte == ' ' || byte == '\t';
+    case Tokenizer_Run_Newline: return byte == '\r' || byte == '\n';
+    case Tokenizer_Run_Identifier: {
+      return code_point_is_ascii_alphanumeric(byte) || byte == '_';
+    }
+    case Tokenizer_Run_Binary: return byte == '0' || byte == '1' || byte == '_';
+    case Tokenizer_Run_Octal: return (byte >= '0' && byte <= '7') || byte == '_';
+    case Tokenizer_Run_Decimal: return code_point_is_digit(byte) || byte == '_';
+    case Tokenizer_Run_Hex: return code_point_is_hex_digit(byte) || byte == '_';
+    case Tokenizer_Run_Comment: return byte != '\r' && byte != '\n';
+    case Tokenizer_Run_String: return byte != '"';
+  }
+  return false;
+}
 
-  Fixed_Buffer *string_buffer = fixed_buffer_make(.capacity = 4096, .allocator = context->temp_allocator);
+typedef struct {
+  u8 from;
+  u8 to;
+} Tokenizer_Byte_Range;
 
-  enum Category {
-    Digit_0,
-    Digit_1,
-    Digits_2_to_7,
-    Digits_8_to_9,
-    Hex_Letter,
-    Non_Hex_Letter,
-    Space,
-    Underscore,
-    Special,
-    Symbols,
-    Newline,
-    Other,
-
-    _Category_Last = Other,
-  };
-  static_assert(_Category_Last < (1 << sizeof(u8) * 8), "Category should fit into a u8");
-  static_assert(_Category_Last < sizeof(u32) * 8, "Category mask should fit into a u32");
+typedef struct {
+  // Ranges of bytes that *belong* to the run
+  Tokenizer_Byte_Range ranges[4];
+  u8 range_count;
+  // When set the run consists of all the bytes *not* in the ranges
+  bool inverted;
+} Tokenizer_Run_Ranges;
 
-  enum {
-    Digits_Mask = (1 << Digit_0) | (1 << Digit_1) | (1 << Digits_2_to_7) | (1 << Digits_8_to_9),
-    Id_Mask = Digits_Mask | (1 << Hex_Letter) | (1 << Non_Hex_Letter) | (1 << Underscore),
-  };
+static const Tokenizer_Run_Ranges tokenizer_run_ranges[] = {
+  [Tokenizer_Run_None] = { .range_count = 0 },
+  [Tokenizer_Run_Space] = { .ranges = {{' ', ' '}, {'\t', '\t'}}, .range_count = 2 },
+  [Tokenizer_Run_Newline] = { .ranges = {{'\r', '\r'}, {'\n', '\n'}}, .range_count = 2 },
+  [Tokenizer_Run_Identifier] = {
+    .ranges = {{'0', '9'}, {'a', 'z'}, {'A', 'Z'}, {'_', '_'}}, .range_count = 4
+  },
+  [Tokenizer_Run_Binary] = { .ranges = {{'0', '1'}, {'_', '_'}}, .range_count = 2 },
+  [Tokenizer_Run_Octal] = { .ranges = {{'0', '7'}, {'_', '_'}}, .range_count = 2 },
+  [Tokenizer_Run_Decimal] = { .ranges = {{'0', '9'}, {'_', '_'}}, .range_count = 2 },
+  [Tokenizer_Run_Hex] = {
+    .ranges = {{'0', '9'}, {'a', 'f'}, {'A', 'F'}, {'_', '_'}}, .range_count = 4
+  },
+  [Tokenizer_Run_Comment] = {
+    .ranges = {{'\r', '\r'}, {'\n', '\n'}}, .range_count = 2, .inverted = true
+  },
+  [Tokenizer_Run_String] = { .ranges = {{'"', '"'}}, .range_count = 1, .inverted = true },
+};
 
-  static u8 CHAR_CATEGORY_MAP[256] = {0};
-  static u32 CATEGORY_CONTINUATION_MASK[_Category_Last + 1] = {
-    [Other] = (1 << Other),
-    [Digit_0] = 0, // Needs special handling
-    [Digit_1] = Digits_Mask | (1 << Underscore),
-    [Digits_2_to_7] = Digits_Mask | (1 << Underscore),
-    [Digits_8_to_9] = Digits_Mask | (1 << Underscore),
-    [Hex_Letter] = Id_Mask,
-    [Non_Hex_Letter] = Id_Mask,
-    [Underscore] = Id_Mask,
-    [Space] = (1 << Space),
-    [Special] = (1 << Space),
-    [Symbols] = (1 << Symbols),
-    [Newline] = (1 << Newline),
-  };
+// Returns the offset of the first byte at or after `offset` that is not part of the `run`.
+// SIMD versions check each range with a `min_epu8` + `cmpeq_epi8` pair which gives
+// an unsigned `from <= byte <= to` comparison available in both SSE2 and AVX2.
+static inline u64
+tokenizer_skip_run_scalar(
+  Tokenizer_Run run,
+  const u8 *bytes,
+  u64 offset,
+  u64 end_offset
+) {
+  for (; offset < end_offset; ++offset) {
+    if (!tokenizer_run_contains(run, bytes[offset])) break;
+  }
+  return offset;
+}
 
-  static u8 DIGIT_DECODER[128] = {0};
+#ifdef PRELUDE_X86_64
+static inline u64
+tokenizer_skip_run_sse2(
+  Tokenizer_Run run,
+  const u8 *bytes,
+  u64 offset,
+  u64 end_offset
+) {
+  const Tokenizer_Run_Ranges *run_ranges = &tokenizer_run_ranges[run];
+  for (; offset + 16 <= end_offset; offset += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + offset));
+    __m128i matched = _mm_setzero_si128();
+    for (u8 i = 0; i < run_ranges->range_count; ++i) {
+      Tokenizer_Byte_Range range = run_ranges->ranges[i];
+      __m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8((char)range.from));
+      __m128i limit = _mm_set1_epi8((char)(range.to - range.from));
+      matched = _mm_or_si128(matched, _mm_cmpeq_epi8(_mm_min_epu8(shifted, limit), shifted));
+    }
+    u32 in_run_mask = (u32)_mm_movemask_epi8(matched);
+    if (run_ranges->inverted) in_run_mask = ~in_run_mask & 0xFFFF;
+    if (in_run_mask != 0xFFFF) {
+      return offset + u32_count_trailing_zeros(~in_run_mask);
+    }
+  }
+  return tokenizer_skip_run_scalar(run, bytes, offset, end_offset);
+}
 
-  static bool tokenizer_initialized = false;
-  if (!tokenizer_initialized) {
-    for (s32 i = 0; i < countof(DIGIT_DECODER); ++i) {
-      DIGIT_DECODER[i] = 0xFF;
+static PRELUDE_TARGET_AVX2 u64
+tokenizer_skip_run_avx2(
+  Tokenizer_Run run,
+  const u8 *bytes,
+  u64 offset,
+  u64 end_offset
+) {
+  const Tokenizer_Run_Ranges *run_ranges = &tokenizer_run_ranges[run];
+  for (; offset + 32 <= end_offset; offset += 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i *)(bytes + offset));
+    __m256i matched = _mm256_setzero_si256();
+    for (u8 i = 0; i < run_ranges->range_count; ++i) {
+      Tokenizer_Byte_Range range = run_ranges->ranges[i];
+      __m256i shifted = _mm256_sub_epi8(chunk, _mm256_set1_epi8((char)range.from));
+      __m256i limit = _mm256_set1_epi8((char)(range.to - range.from));
+      matched = _mm256_or_si256(matched, _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, limit), shifted));
+    }
+    u32 in_run_mask = (u32)_mm256_movemask_epi8(matched);
+    if (run_ranges->inverted) in_run_mask = ~in_run_mask;
+    if (in_run_mask != 0xFFFFFFFF) {
+      return offset + u32_count_trailing_zeros(~in_run_mask);
     }
+  }
+  // The remainder is still likely to be larger than an SSE register
+  return tokenizer_skip_run_sse2(run, bytes, offset, end_offset);
+}
+#endif
 
-    for (s32 i = 0; i < 0x80; ++i) {
-      CHAR_CATEGORY_MAP[i] = Symbols;
+static inline u64
+tokenizer_skip_run(
+  Tokenizer_Scan_Mode mode,
+  Tokenizer_Run run,
+  const u8 *bytes,
+  u64 offset,
+  u64 end_offset
+) {
+  if (run == Tokenizer_Run_None) return offset;
+  switch(mode) {
+    case Tokenizer_Scan_Mode_Auto:
+    case Tokenizer_Scan_Mode_Scalar: {
+      // Scalar mode is the plain byte-by-byte tokenizer loop so there is nothing to skip
+      return offset;
+    }
+    #ifdef PRELUDE_X86_64
+    case Tokenizer_Scan_Mode_Sse2: {
+      return tokenizer_skip_run_sse2(run, bytes, offset, end_offset);
     }
-    for (s32 i = 0x80; i <= 0xFF; ++i) {
-      CHAR_CATEGORY_MAP[i] = Other;
+    case Tokenizer_Scan_Mode_Avx2: {
+      return tokenizer_skip_run_avx2(run, bytes, offset, end_offset);
     }
-    for (s32 ch = 0; ch < ' '; ++ch) {
-      CHAR_CATEGORY_MAP[ch] = Other;
+    #else
+    case Tokenizer_Scan_Mode_Sse2:
+    case Tokenizer_Scan_Mode_Avx2: {
+      return tokenizer_skip_run_scalar(run, bytes, offset, end_offset);
     }
+    #endif
+  }
+  return offset;
+}
 
-    CHAR_CATEGORY_MAP[' '] = Space;
-    CHAR_CATEGORY_MAP['\t'] = Space;
 
-    CHAR_CATEGORY_MAP['\r'] = Newline;
-    CHAR_CATEGORY_MAP['\n'] = Newline;
+typedef enum {
+  Tokenizer_Category_Digit_0,
+  Tokenizer_Category_Digit_1,
+  Tokenizer_Category_Digits_2_to_7,
+  Tokenizer_Category_Digits_8_to_9,
+  Tokenizer_Category_Hex_Letter,
+  Tokenizer_Category_Non_Hex_Letter,
+  Tokenizer_Category_Space,
+  Tokenizer_Category_Underscore,
+  Tokenizer_Category_Special,
+  Tokenizer_Category_Symbols,
+  Tokenizer_Category_Newline,
+  Tokenizer_Category_Other,
 
-    CHAR_CATEGORY_MAP['/'] = Special;
-    CHAR_CATEGORY_MAP['"'] = Special;
-    CHAR_CATEGORY_MAP[';'] = Special;
-    CHAR_CATEGORY_MAP['('] = Special;
-    CHAR_CATEGORY_MAP[')'] = Special;
-    CHAR_CATEGORY_MAP['{'] = Special;
-    CHAR_CATEGORY_MAP['}'] = Special;
-    CHAR_CATEGORY_MAP['['] = Special;
-    CHAR_CATEGORY_MAP[']'] = Special;
+  Tokenizer_Category_Last = Tokenizer_Category_Other,
+} Tokenizer_Category;
+static_assert(Tokenizer_Category_Last < (1 << sizeof(u8) * 8), "Category should fit into a u8");
+static_assert(Tokenizer_Category_Last < sizeof(u32) * 8, "Category mask should fit into a u32");
 
-    CHAR_CATEGORY_MAP['_'] = Underscore;
+enum {
+  Tokenizer_Digits_Mask =
+    (1 << Tokenizer_Category_Digit_0) | (1 << Tokenizer_Category_Digit_1) |
+    (1 << Tokenizer_Category_Digits_2_to_7) | (1 << Tokenizer_Category_Digits_8_to_9),
+  Tokenizer_Id_Mask = Tokenizer_Digits_Mask |
+    (1 << Tokenizer_Category_Hex_Letter) | (1 << Tokenizer_Category_Non_Hex_Letter) |
+    (1 << Tokenizer_Category_Underscore),
+};
 
-    for (char ch = '0'; ch <= (char)'9'; ++ch) {
-      DIGIT_DECODER[ch] = ch - '0';
-    }
-    CHAR_CATEGORY_MAP['0'] = Digit_0;
-    CHAR_CATEGORY_MAP['1'] = Digit_1;
-    for (char ch = '2'; ch <= (char)'7'; ++ch) {
-      CHAR_CATEGORY_MAP[ch] = Digits_2_to_7;
-    }
-    CHAR_CATEGORY_MAP['8'] = Digits_8_to_9;
-    CHAR_CATEGORY_MAP['9'] = Digits_8_to_9;
+static u8 tokenizer_char_category_map[256] = {0};
+static const u32 tokenizer_category_continuation_mask[Tokenizer_Category_Last + 1] = {
+  [Tokenizer_Category_Other] = (1 << Tokenizer_Category_Other),
+  [Tokenizer_Category_Digit_0] = 0, // Needs special handling
+  [Tokenizer_Category_Digit_1] = Tokenizer_Digits_Mask | (1 << Tokenizer_Category_Underscore),
+  [Tokenizer_Category_Digits_2_to_7] = Tokenizer_Digits_Mask | (1 << Tokenizer_Category_Underscore),
+  [Tokenizer_Category_Digits_8_to_9] = Tokenizer_Digits_Mask | (1 << Tokenizer_Category_Underscore),
+  [Tokenizer_Category_Hex_Letter] = Tokenizer_Id_Mask,
+  [Tokenizer_Category_Non_Hex_Letter] = Tokenizer_Id_Mask,
+  [Tokenizer_Category_Underscore] = Tokenizer_Id_Mask,
+  [Tokenizer_Category_Space] = (1 << Tokenizer_Category_Space),
+  [Tokenizer_Category_Special] = (1 << Tokenizer_Category_Space),
+  [Tokenizer_Category_Symbols] = (1 << Tokenizer_Category_Symbols),
+  [Tokenizer_Category_Newline] = (1 << Tokenizer_Category_Newline),
+};
+// Must accept exactly the same bytes as the matching `tokenizer_category_continuation_mask` entry
+static const Tokenizer_Run tokenizer_category_continuation_run[Tokenizer_Category_Last + 1] = {
+  [Tokenizer_Category_Other] = Tokenizer_Run_None,
+  [Tokenizer_Category_Digit_0] = Tokenizer_Run_None,
+  [Tokenizer_Category_Digit_1] = Tokenizer_Run_Decimal,
+  [Tokenizer_Category_Digits_2_to_7] = Tokenizer_Run_Decimal,
+  [Tokenizer_Category_Digits_8_to_9] = Tokenizer_Run_Decimal,
+  [Tokenizer_Category_Hex_Letter] = Tokenizer_Run_Identifier,
+  [Tokenizer_Category_Non_Hex_Letter] = Tokenizer_Run_Identifier,
+  [Tokenizer_Category_Underscore] = Tokenizer_Run_Identifier,
+  [Tokenizer_Category_Space] = Tokenizer_Run_Space,
+  [Tokenizer_Category_Special] = Tokenizer_Run_Space,
+  [Tokenizer_Category_Symbols] = Tokenizer_Run_None,
+  [Tokenizer_Category_Newline] = Tokenizer_Run_Newline,
+};
+static u8 tokenizer_digit_decoder[128] = {0};
 
-    for (char ch = 'a'; ch <= (char)'f'; ++ch) {
-      CHAR_CATEGORY_MAP[ch] = Hex_Letter;
-      DIGIT_DECODER[ch] = ch - 'a' + 10;
-    }
-    for (char ch = 'A'; ch <= (char)'F'; ++ch) {
-      CHAR_CATEGORY_MAP[ch] = Hex_Letter;
-      DIGIT_DECODER[ch] = ch - 'A' + 10;
-    }
+// Must be called on the main thread before any scanning starts since
+// the tables are shared with all of the tokenizer workers.
+static void
+tokenizer_tables_init() {
+  static bool tokenizer_initialized = false;
+  if (tokenizer_initialized) return;
+  tokenizer_initialized = true;
 
-    for (char ch = 'f' + 1; ch <= (char)'z'; ++ch) {
-      CHAR_CATEGORY_MAP[ch] = Non_Hex_Letter;
-    }
-    for (char ch = 'F' + 1; ch <= (char)'Z'; ++ch) {
-      CHAR_CATEGORY_MAP[ch] = Non_Hex_Letter;
-    }
+  u8 *map = tokenizer_char_category_map;
+  for (s32 i = 0; i < countof(tokenizer_digit_decoder); ++i) {
+    tokenizer_digit_decoder[i] = 0xFF;
   }
 
-  u64 offset = source_range.offsets.from;
-  u64 end_offset = source_range.offsets.to;
+  for (s32 i = 0; i < 0x80; ++i) {
+    map[i] = Tokenizer_Category_Symbols;
+  }
+  for (s32 i = 0x80; i <= 0xFF; ++i) {
+    map[i] = Tokenizer_Category_Other;
+  }
+  for (s32 ch = 0; ch < ' '; ++ch) {
+    map[ch] = Tokenizer_Category_Other;
+  }
 
-  // Create top-level block
-  tokenizer_group_start_curly(context, &state, offset);
+  map[' '] = Tokenizer_Category_Space;
+  map['\t'] = Tokenizer_Category_Space;
+
+  map['\r'] = Tokenizer_Category_Newline;
+  map['\n'] = Tokenizer_Category_Newline;
+
+  map['/'] = Tokenizer_Category_Special;
+  map['"'] = Tokenizer_Category_Special;
+  map[';'] = Tokenizer_Category_Special;
+  map['('] = Tokenizer_Category_Special;
+  map[')'] = Tokenizer_Category_Special;
+  map['{'] = Tokenizer_Category_Special;
+  map['}'] = Tokenizer_Category_Special;
+  map['['] = Tokenizer_Category_Special;
+  map[']'] = Tokenizer_Category_Special;
+
+  map['_'] = Tokenizer_Category_Underscore;
+
+  for (char ch = '0'; ch <= (char)'9'; ++ch) {
+    tokenizer_digit_decoder[ch] = ch - '0';
+  }
+  map['0'] = Tokenizer_Category_Digit_0;
+  map['1'] = Tokenizer_Category_Digit_1;
+  for (char ch = '2'; ch <= (char)'7'; ++ch) {
+    map[ch] = Tokenizer_Category_Digits_2_to_7;
+  }
+  map['8'] = Tokenizer_Category_Digits_8_to_9;
+  map['9'] = Tokenizer_Category_Digits_8_to_9;
+
+  for (char ch = 'a'; ch <= (char)'f'; ++ch) {
+    map[ch] = Tokenizer_Category_Hex_Letter;
+    tokenizer_digit_decoder[ch] = ch - 'a' + 10;
+  }
+  for (char ch = 'A'; ch <= (char)'F'; ++ch) {
+    map[ch] = Tokenizer_Category_Hex_Letter;
+    tokenizer_digit_decoder[ch] = ch - 'A' + 10;
+  }
+
+  for (char ch = 'f' + 1; ch <= (char)'z'; ++ch) {
+    map[ch] = Tokenizer_Category_Non_Hex_Letter;
+  }
+  for (char ch = 'F' + 1; ch <= (char)'Z'; ++ch) {
+    map[ch] = Tokenizer_Category_Non_Hex_Letter;
+  }
+}
+
+typedef enum {
+  Tokenizer_Token_Tag_Number,
+  Tokenizer_Token_Tag_Symbol,
+  Tokenizer_Token_Tag_String,
+  Tokenizer_Token_Tag_Statement_End,
+  Tokenizer_Token_Tag_Paren_Start,
+  Tokenizer_Token_Tag_Square_Start,
+  Tokenizer_Token_Tag_Curly_Start,
+  Tokenizer_Token_Tag_Paren_End,
+  Tokenizer_Token_Tag_Square_End,
+  Tokenizer_Token_Tag_Curly_End,
+} Tokenizer_Token_Tag;
+
+// Scanning only records what was found and where. Turning that into `Value`s
+// needs the compilation allocator and the symbol table, neither of which is
+// thread-safe, so it is done afterwards on the calling thread.
+typedef struct {
+  Tokenizer_Token_Tag tag;
+  Range_u32 offsets;
+  u64 number;
+} Tokenizer_Token;
+typedef dyn_array_type(Tokenizer_Token) Array_Tokenizer_Token;
+
+typedef struct {
+  Range_u32 offsets;
+  Array_Tokenizer_Token tokens;
+  // Scanning stops at the first error which is reported once all
+  // the tokens before it in the whole file have been processed
+  Slice error_message;
+  u64 error_offset;
+} Tokenizer_Chunk;
+typedef dyn_array_type(Tokenizer_Chunk) Array_Tokenizer_Chunk;
+
+static inline Tokenizer_Token *
+tokenizer_chunk_push(
+  Tokenizer_Chunk *chunk,
+  Tokenizer_Token_Tag tag,
+  u64 from,
+  u64 to
+) {
+  return dyn_array_push(chunk->tokens, (Tokenizer_Token) {
+    .tag = tag,
+    .offsets = {.from = u64_to_u32(from), .to = u64_to_u32(to)},
+  });
+}
+
+// Every byte can end at most one token and the end of the chunk can finalize one more
+static inline u64
+tokenizer_chunk_max_token_count(
+  const Tokenizer_Chunk *chunk
+) {
+  return range_length(chunk->offsets) + 1;
+}
+
+static void
+tokenizer_scan_chunk(
+  const Allocator *allocator,
+  Tokenizer_Scan_Mode scan_mode,
+  Slice input,
+  Tokenizer_Chunk *chunk,
+  u64 initial_capacity
+) {
+  const u8 *input_bytes = (const u8 *)input.bytes;
+  u64 offset = chunk->offsets.from;
+  u64 end_offset = chunk->offsets.to;
+  u64 token_start_offset = offset;
+
+  chunk->tokens = dyn_array_make(
+    Array_Tokenizer_Token, .allocator = allocator, .capacity = initial_capacity
+  );
+  chunk->error_message = (Slice){0};
 
   bool should_finalize = true;
-  enum Category starting_category = Space;
+  Tokenizer_Category starting_category = Tokenizer_Category_Space;
   char current = 0;
-  enum Category category = Space;
+  Tokenizer_Category category = Tokenizer_Category_Space;
   u32 continuation_mask = 0;
+  Tokenizer_Run continuation_run = Tokenizer_Run_None;
   u32 number_base = 10;
 
   for (; offset < end_offset; ++offset) {
     current = input.bytes[offset];
-    category = CHAR_CATEGORY_MAP[current];
+    category = tokenizer_char_category_map[(u8)current];
 
-    if ((1 << category) & continuation_mask) continue;
+    if ((1 << category) & continuation_mask) {
+      // Skip the rest of the run in bulk; the loop increment then steps over its last byte
+      offset = tokenizer_skip_run(scan_mode, continuation_run, input_bytes, offset + 1, end_offset) - 1;
+      continue;
+    }
 
     finalize:
     switch(starting_category) {
-      case Newline: {
-        tokenizer_maybe_push_statement(context, &state, offset);
+      case Tokenizer_Category_Newline: {
+        tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Statement_End, offset, offset);
       } break;
-      case Digit_0: {
-        if ((1 << category) & Digits_Mask) { // e.g. 0777
-          Slice message = slice_literal(
+      case Tokenizer_Category_Digit_0: {
+        if ((1 << category) & Tokenizer_Digits_Mask) { // e.g. 0777
+          chunk->error_message = slice_literal(
             "Numbers are not allowed to have `0` at the start.\n"
             "If you meant to specify an octal number, prefix it with `0o`"
           );
-          tokenizer_handle_error(&state, message, offset);
-          goto defer;
+          chunk->error_offset = offset;
+          return;
         }
         if (current == 'b') {
           number_base = 2;
-          starting_category = Digit_1;
-          continuation_mask = (1 << Digit_0) | (1 << Digit_1) | (1 << Underscore);
+          starting_category = Tokenizer_Category_Digit_1;
+          continuation_mask =
+            (1 << Tokenizer_Category_Digit_0) | (1 << Tokenizer_Category_Digit_1) |
+            (1 << Tokenizer_Category_Underscore);
+          continuation_run = Tokenizer_Run_Binary;
           continue;
         } else if (current == 'o') {
           number_base = 8;
-          starting_category = Digits_2_to_7;
-          continuation_mask = (1 << Digit_0) | (1 << Digit_1) | (1 << Digits_2_to_7) | (1 << Underscore);
+          starting_category = Tokenizer_Category_Digits_2_to_7;
+          continuation_mask =
+            (1 << Tokenizer_Category_Digit_0) | (1 << Tokenizer_Category_Digit_1) |
+            (1 << Tokenizer_Category_Digits_2_to_7) | (1 << Tokenizer_Category_Underscore);
+          continuation_run = Tokenizer_Run_Octal;
           continue;
         } else if (current == 'x') {
           number_base = 16;
-          starting_category = Digits_8_to_9;
-          continuation_mask = Digits_Mask | (1 << Hex_Letter) | (1 << Underscore);
+          starting_category = Tokenizer_Category_Digits_8_to_9;
+          continuation_mask = Tokenizer_Digits_Mask |
+            (1 << Tokenizer_Category_Hex_Letter) | (1 << Tokenizer_Category_Underscore);
+          continuation_run = Tokenizer_Run_Hex;
           continue;
         }
         number_base = 10;
       } // fall through
-      case Digit_1:
-      case Digits_2_to_7:
-      case Digits_8_to_9: {
+      case Tokenizer_Category_Digit_1:
+      case Tokenizer_Category_Digits_2_to_7:
+      case Tokenizer_Category_Digits_8_to_9: {
         u64 digit_index = 0;
         if (number_base != 10) digit_index += 2; // Skip over `0b`, `0o` or `0x`
-        Slice source = slice_sub(input, state.token_start_offset, offset);
+        Slice source = slice_sub(input, token_start_offset, offset);
         u64 literal = 0;
 
         if (digit_index != source.length) {
           for(;;) {
             char ch = source.bytes[digit_index];
             if (ch != '_') {
-              u8 digit = DIGIT_DECODER[ch];
+              u8 digit = tokenizer_digit_decoder[ch];
               assert(digit < number_base);
               literal += digit;
             }
@@ -485,91 +761,75 @@ tokenize(
             literal *= number_base;
           }
         }
-        Source_Range digit_range = tokenizer_token_range(&state, offset);
-        Value *value = value_make(context, &descriptor_i64, storage_immediate(&literal), digit_range);
-        dyn_array_push(state.token_stack, value);
+        Tokenizer_Token *token = tokenizer_chunk_push(
+          chunk, Tokenizer_Token_Tag_Number, token_start_offset, offset
+        );
+        token->number = literal;
         number_base = 10;
       } break;
-      case Underscore:
-      case Hex_Letter:
-      case Non_Hex_Letter:
-      case Symbols: {
-        Slice name = slice_sub(input, state.token_start_offset, offset);
-        const Symbol *symbol = mass_ensure_symbol(context->compilation, name);
-        Source_Range symbol_range = tokenizer_token_range(&state, offset);
-        Value *value = value_make(context, &descriptor_symbol, storage_static(symbol), symbol_range);
-        dyn_array_push(state.token_stack, value);
+      case Tokenizer_Category_Underscore:
+      case Tokenizer_Category_Hex_Letter:
+      case Tokenizer_Category_Non_Hex_Letter:
+      case Tokenizer_Category_Symbols: {
+        tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Symbol, token_start_offset, offset);
       } break;
-      case Space: {
+      case Tokenizer_Category_Space: {
         // Nothing to do
       } break;
-      case Other: {
-        tokenizer_handle_error(&state, slice_literal("Unexpected character"), offset);
-        goto defer;
+      case Tokenizer_Category_Other: {
+        chunk->error_message = slice_literal("Unexpected character");
+        chunk->error_offset = offset;
+        return;
       } break;
-      case Special: {
+      case Tokenizer_Category_Special: {
         panic("UNREACHEABLE");
       } break;
     }
-    state.token_start_offset = offset;
+    token_start_offset = offset;
 
-    if (category == Special) {
-      category = Space;
+    if (category == Tokenizer_Category_Special) {
+      category = Tokenizer_Category_Space;
       switch(current) {
         case '"': {
           ++offset;
           bool found_end = false;
           for (; offset < end_offset; ++offset) {
+            offset = tokenizer_skip_run(scan_mode, Tokenizer_Run_String, input_bytes, offset, end_offset);
+            if (offset == end_offset) break;
             char current = input.bytes[offset];
             if (current == '"') {
               if (input.bytes[offset - 1] != '\\') {
                 found_end = true;
-                Slice raw_bytes = slice_sub(input, state.token_start_offset + 1, offset);
-                Source_Range string_range = tokenizer_token_range(&state, offset);
-                string_range.offsets.to += 1;
-                tokenizer_push_string_literal(
-                  context, &string_buffer, &state.token_stack, raw_bytes, string_range
-                );
+                tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_String, token_start_offset, offset + 1);
                 break;
               }
             }
           }
           if (!found_end) {
-            tokenizer_handle_error(&state, slice_literal("Unterminated string"), offset);
-            goto defer;
+            chunk->error_message = slice_literal("Unterminated string");
+            chunk->error_offset = offset;
+            return;
           }
         } break;
         case '/': {
           if (offset + 1 < end_offset && input.bytes[offset + 1] == '/') {
-            starting_category = Space;
-            continuation_mask = ~(1u << Newline);
+            starting_category = Tokenizer_Category_Space;
+            continuation_mask = ~(1u << Tokenizer_Category_Newline);
+            continuation_run = Tokenizer_Run_Comment;
             continue;
           } else {
-            category = Symbols;
+            category = Tokenizer_Category_Symbols;
           }
         } break;
-        case ';': { tokenizer_maybe_push_statement(context, &state, offset + 1); } break;
-        case '(': { tokenizer_group_start_paren(context, &state, offset); } break;
-        case '[': { tokenizer_group_start_square(context, &state, offset); } break;
-        case '{': { tokenizer_group_start_curly(context, &state, offset); } break;
-        case ')': {
-          if (!tokenizer_group_end_paren(context, &state, offset + 1)) {
-            tokenizer_handle_error(&state, slice_literal("Expected a `)`"), offset);
-            goto defer;
-          }
-        } break;
-        case ']': {
-          if (!tokenizer_group_end_square(context, &state, offset + 1)) {
-            tokenizer_handle_error(&state, slice_literal("Expected a `]`"), offset);
-            goto defer;
-          }
-        } break;
-        case '}': {
-          if (!tokenizer_group_end_curly(context, &state, offset + 1)) {
-            tokenizer_handle_error(&state, slice_literal("Expected a `}`"), offset);
-            goto defer;
-          }
+        case ';': {
+          tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Statement_End, offset + 1, offset + 1);
         } break;
+        case '(': tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Paren_Start, offset, offset); break;
+        case '[': tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Square_Start, offset, offset); break;
+        case '{': tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Curly_Start, offset, offset); break;
+        case ')': tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Paren_End, offset, offset + 1); break;
+        case ']': tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Square_End, offset, offset + 1); break;
+        case '}': tokenizer_chunk_push(chunk, Tokenizer_Token_Tag_Curly_End, offset, offset + 1); break;
         default: {
           panic("UNREACHEABLE");
         } break;
@@ -577,21 +837,469 @@ tokenize(
     }
 
     starting_category = category;
-    continuation_mask = CATEGORY_CONTINUATION_MASK[starting_category];
+    continuation_mask = tokenizer_category_continuation_mask[starting_category];
+    continuation_run = tokenizer_category_continuation_run[starting_category];
   }
 
   if (should_finalize) {
     should_finalize = false;
-    category = Space;
+    category = Tokenizer_Category_Space;
     goto finalize;
   }
+}
+
+// Chunks are split at the points where the serial tokenizer would be at the top level
+// of the root block right after finishing a statement, i.e. after a `;` or after a run
+// of newlines outside of any group, string or comment. The state of the tokenizer is
+// then exactly the same as at the start of the input, so each chunk can be scanned
+// independently and still produce the same tokens as scanning everything at once.
+static Array_Tokenizer_Chunk
+tokenizer_split_into_chunks(
+  const Allocator *allocator,
+  Tokenizer_Scan_Mode scan_mode,
+  Slice input,
+  Range_u32 offsets,
+  u64 chunk_byte_size
+) {
+  assert(chunk_byte_size);
+  Array_Tokenizer_Chunk chunks = dyn_array_make(
+    Array_Tokenizer_Chunk, .allocator = allocator, .capacity = range_length(offsets) / chunk_byte_size + 1
+  );
+  const u8 *bytes = (const u8 *)input.bytes;
+  u64 chunk_start_offset = offsets.from;
+  u64 end_offset = offsets.to;
+  s64 depth = 0;
+
+  for (u64 offset = chunk_start_offset; offset < end_offset; ++offset) {
+    switch(bytes[offset]) {
+      case '(': case '[': case '{': {
+        depth += 1;
+      } break;
+      case ')': case ']': case '}': {
+        // Unbalanced input is going to be an error anyway so no point splitting it further
+        depth -= 1;
+        if (depth < 0) goto done;
+      } break;
+      case '"': {
+        for (offset += 1; ; ++offset) {
+          offset = tokenizer_skip_run(scan_mode, Tokenizer_Run_String, bytes, offset, end_offset);
+          if (offset == end_offset) goto done; // Unterminated string
+          if (bytes[offset] == '"' && bytes[offset - 1] != '\\') break;
+        }
+      } break;
+      case '/': {
+        if (offset + 1 < end_offset && bytes[offset + 1] == '/') {
+          for (offset += 2; offset < end_offset; ++offset) {
+            offset = tokenizer_skip_run(scan_mode, Tokenizer_Run_Comment, bytes, offset, end_offset);
+            if (offset == end_offset || !tokenizer_run_contains(Tokenizer_Run_Comment, bytes[offset])) break;
+          }
+          // Let the loop increment land on the newline ending the comment
+          offset -= 1;
+        }
+      } break;
+      case ';': case '\r': case '\n': {
+        if (depth != 0) break;
+        u64 boundary = offset + 1;
+        if (bytes[offset] != ';') {
+          if (boundary < end_offset && tokenizer_run_contains(Tokenizer_Run_Newline, bytes[boundary])) break;
+        }
+        if (boundary < end_offset && boundary - chunk_start_offset >= chunk_byte_size) {
+          dyn_array_push(chunks, (Tokenizer_Chunk) {
+            .offsets = {.from = u64_to_u32(chunk_start_offset), .to = u64_to_u32(boundary)},
+          });
+          chunk_start_offset = boundary;
+        }
+      } break;
+    }
+  }
+
+  done:
+  dyn_array_push(chunks, (Tokenizer_Chunk) {
+    .offsets = {.from = u64_to_u32(chunk_start_offset), .to = u64_to_u32(end_offset)},
+  });
+  return chunks;
+}
 
-  if (dyn_array_length(state.parent_stack) != 1) {
+// Inputs smaller than this are not worth the cost of starting the threads.
+// All of these values can be overridden (mostly for testing).
+static u64 tokenizer_parallel_min_byte_size = 1024 * 1024;
+static u64 tokenizer_parallel_chunk_byte_size = 128 * 1024;
+// Zero means one worker per logical processor
+static u64 tokenizer_parallel_max_worker_count = 0;
+
+typedef struct {
+  Slice input;
+  Tokenizer_Scan_Mode scan_mode;
+  Tokenizer_Chunk *chunks;
+  u64 chunk_count;
+} Tokenizer_Parallel_Job;
+
+typedef struct {
+  Tokenizer_Parallel_Job *job;
+  Thread thread;
+  // Chunks are handed out up front so that the arena can be sized for just these
+  u64 chunk_from;
+  u64 chunk_to;
+  // Each worker gets its own arena as the context temp one is not thread-safe
+  Virtual_Memory_Buffer temp_buffer;
+  Allocator temp_allocator;
+} Tokenizer_Worker;
+
+static void
+tokenizer_worker_proc(
+  void *data
+) {
+  Tokenizer_Worker *worker = data;
+  Tokenizer_Parallel_Job *job = worker->job;
+  for (u64 chunk_index = worker->chunk_from; chunk_index < worker->chunk_to; ++chunk_index) {
+    Tokenizer_Chunk *chunk = &job->chunks[chunk_index];
+    // Token arrays never grow so the arena only needs to fit the worst case once
+    u64 capacity = tokenizer_chunk_max_token_count(chunk);
+    tokenizer_scan_chunk(&worker->temp_allocator, job->scan_mode, job->input, chunk, capacity);
+  }
+}
+
+// The calling thread is used as the first worker, so only `worker_count - 1` threads are started
+static void
+tokenizer_scan_chunks_in_parallel(
+  Tokenizer_Parallel_Job *job,
+  Tokenizer_Worker *workers,
+  u64 worker_count
+) {
+  assert(worker_count <= job->chunk_count);
+  u64 input_from = job->chunks[0].offsets.from;
+  u64 input_byte_size = job->chunks[job->chunk_count - 1].offsets.to - input_from;
+  // Split the chunks into contiguous runs of roughly the same byte size,
+  // leaving at least one chunk for each of the remaining workers
+  u64 chunk_index = 0;
+  for (u64 i = 0; i < worker_count; ++i) {
+    Tokenizer_Worker *worker = &workers[i];
+    *worker = (Tokenizer_Worker) { .job = job, .chunk_from = chunk_index };
+    u64 target_to = input_from + input_byte_size * (i + 1) / worker_count;
+    u64 max_chunk_to = job->chunk_count - (worker_count - i - 1);
+    u64 max_token_count = 0;
+    do {
+      max_token_count += tokenizer_chunk_max_token_count(&job->chunks[chunk_index]);
+      chunk_index += 1;
+    } while (chunk_index < max_chunk_to && job->chunks[chunk_index - 1].offsets.to < target_to);
+    worker->chunk_to = chunk_index;
+
+    // Extra space covers the alignment of each of the token arrays
+    u64 temp_byte_size = max_token_count * sizeof(Tokenizer_Token) + 64 * 1024;
+    virtual_memory_buffer_init(&worker->temp_buffer, temp_byte_size);
+    virtual_memory_buffer_allocator_init(&worker->temp_buffer, &worker->temp_allocator);
+  }
+  assert(chunk_index == job->chunk_count);
+  for (u64 i = 1; i < worker_count; ++i) {
+    workers[i].thread = thread_make(tokenizer_worker_proc, &workers[i]);
+  }
+  tokenizer_worker_proc(&workers[0]);
+  for (u64 i = 1; i < worker_count; ++i) {
+    thread_join(workers[i].thread);
+  }
+}
+
+typedef struct {
+  // Index into the token stream of the token that opened the group
+  u32 index;
+  bool has_children;
+  // Mirrors how `tokenizer_maybe_push_statement` updates the end of the block value
+  u32 statement_end_offset;
+} Tokenizer_Group_Start;
+typedef dyn_array_type(Tokenizer_Group_Start) Array_Tokenizer_Group_Start;
+
+// Turns scanned chunks into the packed stream, interning all of the symbols.
+// This also matches up all of the groups which lets nested blocks be built
+// lazily while still reporting unbalanced groups right away. For each `{`
+// the payload is the index of the matching `}` and the payload of that `}`
+// is the end offset of the source range the block value would get if it
+// was built eagerly.
+static bool
+tokenizer_stream_from_chunks(
+  Mass_Context *context,
+  Tokenizer_State *state,
+  Slice input,
+  const Array_Tokenizer_Chunk chunks,
+  u64 end_offset,
+  Token_Stream *stream
+) {
+  u64 count = 0;
+  DYN_ARRAY_FOREACH(Tokenizer_Chunk, chunk, chunks) {
+    count += dyn_array_length(chunk->tokens);
+  }
+  assert(count < UINT32_MAX);
+  *stream = (Token_Stream) {
+    .file = state->source_file,
+    .tags = allocator_allocate_array(context->allocator, u8, count),
+    .offsets = allocator_allocate_array(context->allocator, u32, count),
+    .lengths = allocator_allocate_array(context->allocator, u32, count),
+    .payloads = allocator_allocate_array(context->allocator, u64, count),
+    .count = u64_to_u32(count),
+  };
+
+  // The root block can not be closed from the source, so it is always at the bottom
+  const u32 root_index = UINT32_MAX;
+  Array_Tokenizer_Group_Start group_stack = dyn_array_make(
+    Array_Tokenizer_Group_Start, .allocator = context->temp_allocator, .capacity = 32
+  );
+  dyn_array_push(group_stack, (Tokenizer_Group_Start){ .index = root_index });
+
+  u32 index = 0;
+  DYN_ARRAY_FOREACH(Tokenizer_Chunk, chunk, chunks) {
+    DYN_ARRAY_FOREACH(Tokenizer_Token, token, chunk->tokens) {
+      Tokenizer_Group_Start *parent = dyn_array_last(group_stack);
+      u64 payload = 0;
+      switch(token->tag) {
+        case Tokenizer_Token_Tag_Number: {
+          parent->has_children = true;
+          payload = token->number;
+        } break;
+        case Tokenizer_Token_Tag_Symbol: {
+          parent->has_children = true;
+          Slice name = slice_sub(input, token->offsets.from, token->offsets.to);
+          payload = (u64)(uintptr_t)mass_ensure_symbol(context->compilation, name);
+        } break;
+        case Tokenizer_Token_Tag_String: {
+          parent->has_children = true;
+        } break;
+        case Tokenizer_Token_Tag_Statement_End: {
+          bool is_block = parent->index == root_index ||
+            stream->tags[parent->index] == Tokenizer_Token_Tag_Curly_Start;
+          if (is_block && parent->has_children) {
+            parent->has_children = false;
+            parent->statement_end_offset = token->offsets.from;
+          }
+        } break;
+        case Tokenizer_Token_Tag_Paren_Start:
+        case Tokenizer_Token_Tag_Square_Start:
+        case Tokenizer_Token_Tag_Curly_Start: {
+          parent->has_children = true;
+          dyn_array_push(group_stack, (Tokenizer_Group_Start){
+            .index = index,
+            .statement_end_offset = token->offsets.from,
+          });
+        } break;
+        case Tokenizer_Token_Tag_Paren_End:
+        case Tokenizer_Token_Tag_Square_End:
+        case Tokenizer_Token_Tag_Curly_End: {
+          Tokenizer_Token_Tag start_tag =
+            parent->index == root_index ? Tokenizer_Token_Tag_Curly_Start : stream->tags[parent->index];
+          Tokenizer_Token_Tag expected_tag =
+            token->tag == Tokenizer_Token_Tag_Paren_End ? Tokenizer_Token_Tag_Paren_Start :
+            token->tag == Tokenizer_Token_Tag_Square_End ? Tokenizer_Token_Tag_Square_Start :
+            Tokenizer_Token_Tag_Curly_Start;
+          if (parent->index == root_index || start_tag != expected_tag) {
+            Slice message =
+              token->tag == Tokenizer_Token_Tag_Paren_End ? slice_literal("Expected a `)`") :
+              token->tag == Tokenizer_Token_Tag_Square_End ? slice_literal("Expected a `]`") :
+              slice_literal("Expected a `}`");
+            tokenizer_handle_error(state, message, token->offsets.from);
+            return false;
+          }
+          if (token->tag == Tokenizer_Token_Tag_Curly_End) {
+            if (parent->has_children) parent->statement_end_offset = token->offsets.to;
+            payload = parent->statement_end_offset;
+          }
+          stream->payloads[parent->index] = index;
+          dyn_array_pop(group_stack);
+        } break;
+      }
+      stream->tags[index] = u32_to_u8(token->tag);
+      stream->offsets[index] = token->offsets.from;
+      stream->lengths[index] = token->offsets.to - token->offsets.from;
+      stream->payloads[index] = payload;
+      index += 1;
+    }
+    if (chunk->error_message.length) {
+      tokenizer_handle_error(state, chunk->error_message, chunk->error_offset);
+      return false;
+    }
+  }
+
+  if (dyn_array_length(group_stack) != 1) {
     Slice message = slice_literal("Unexpected end of file. Expected a closing brace.");
-    tokenizer_handle_error(&state, message, offset - 1);
-    goto defer;
+    tokenizer_handle_error(state, message, end_offset);
+    return false;
+  }
+  return true;
+}
+
+static void
+tokenizer_build_tokens(
+  Mass_Context *context,
+  Tokenizer_State *state,
+  Fixed_Buffer **string_buffer,
+  const Token_Stream *stream,
+  u32 from_index,
+  u32 to_index
+) {
+  Slice input = stream->file->text;
+  for (u32 index = from_index; index < to_index; ++index) {
+    u64 from = stream->offsets[index];
+    u64 to = from + stream->lengths[index];
+    switch(stream->tags[index]) {
+      case Tokenizer_Token_Tag_Number: {
+        Source_Range digit_range = tokenizer_token_range(state, from, to);
+        Value *value = value_make(
+          context, &descriptor_i64, storage_immediate(&stream->payloads[index]), digit_range
+        );
+        dyn_array_push(state->token_stack, value);
+      } break;
+      case Tokenizer_Token_Tag_Symbol: {
+        const Symbol *symbol = (const Symbol *)(uintptr_t)stream->payloads[index];
+        Source_Range symbol_range = tokenizer_token_range(state, from, to);
+        Value *value = value_make(context, &descriptor_symbol, storage_static(symbol), symbol_range);
+        dyn_array_push(state->token_stack, value);
+      } break;
+      case Tokenizer_Token_Tag_String: {
+        Slice raw_bytes = slice_sub(input, from + 1, to - 1);
+        Source_Range string_range = tokenizer_token_range(state, from, to);
+        tokenizer_push_string_literal(
+          context, string_buffer, &state->token_stack, raw_bytes, string_range
+        );
+      } break;
+      case Tokenizer_Token_Tag_Statement_End: {
+        tokenizer_maybe_push_statement(context, state, from);
+      } break;
+      case Tokenizer_Token_Tag_Paren_Start: tokenizer_group_start_paren(context, state, from); break;
+      case Tokenizer_Token_Tag_Square_Start: tokenizer_group_start_square(context, state, from); break;
+      case Tokenizer_Token_Tag_Curly_Start: {
+        u32 end_index = u64_to_u32(stream->payloads[index]);
+        Ast_Block *block = mass_allocate(context, Ast_Block);
+        *block = (Ast_Block) {
+          .lazy_stream = stream,
+          .lazy_from_token = index + 1,
+          .lazy_to_token = end_index,
+        };
+        Source_Range source_range = tokenizer_token_range(state, from, stream->payloads[end_index]);
+        Value *value = value_make(context, &descriptor_ast_block, storage_static(block), source_range);
+        dyn_array_push(state->token_stack, value);
+        // The contents are built on demand by `tokenizer_ast_block_ensure_built`
+        index = end_index;
+      } break;
+      case Tokenizer_Token_Tag_Paren_End: {
+        if (!tokenizer_group_end_paren(context, state, to)) panic("Groups are matched in the stream");
+      } break;
+      case Tokenizer_Token_Tag_Square_End: {
+        if (!tokenizer_group_end_square(context, state, to)) panic("Groups are matched in the stream");
+      } break;
+      case Tokenizer_Token_Tag_Curly_End: {
+        panic("Curly groups are always skipped over");
+      } break;
+    }
   }
+}
+
+static void
+tokenizer_ast_block_ensure_built(
+  Mass_Context *context,
+  const Ast_Block *const_block
+) {
+  const Token_Stream *stream = const_block->lazy_stream;
+  if (!stream) return;
+  // Building the statements does not logically change the block, it is just a cache fill
+  Ast_Block *block = (Ast_Block *)const_block;
+  block->lazy_stream = 0;
 
+  Temp_Mark temp_mark = context_temp_mark(context);
+  Tokenizer_State state = {
+    .token_stack = dyn_array_make(
+      Array_Value_Ptr, .allocator = context->temp_allocator, .capacity = 100
+    ),
+    .parent_stack = dyn_array_make(
+      Array_Tokenizer_Parent, .allocator = context->temp_allocator, .capacity = 32
+    ),
+    .source_file = stream->file,
+    .result = {.tag = Mass_Result_Tag_Success},
+  };
+  Fixed_Buffer *string_buffer = fixed_buffer_make(.capacity = 4096, .allocator = context->temp_allocator);
+
+  u32 start_index = block->lazy_from_token - 1;
+  u32 end_index = block->lazy_to_token;
+  u64 start_offset = stream->offsets[start_index];
+  Value block_value;
+  value_init(
+    &block_value, &descriptor_ast_block, storage_static(block),
+    tokenizer_token_range(&state, start_offset, start_offset)
+  );
+  tokenizer_group_push(&state, &block_value);
+  tokenizer_build_tokens(context, &state, &string_buffer, stream, start_index + 1, end_index);
+  u64 end_offset = stream->offsets[end_index] + stream->lengths[end_index];
+  if (!tokenizer_group_end_curly(context, &state, end_offset)) panic("UNREACHEABLE");
+
+  context_temp_reset_to_mark(context, temp_mark);
+}
+
+static PRELUDE_NO_DISCARD Mass_Result
+tokenize(
+  Mass_Context *context,
+  Source_Range source_range,
+  Ast_Block *out_block
+) {
+  Slice input = source_range.file->text;
+  Temp_Mark temp_mark = context_temp_mark(context);
+  Tokenizer_State state = {
+    .token_stack = dyn_array_make(
+      Array_Value_Ptr, .allocator = context->temp_allocator, .capacity = 100
+    ),
+    .parent_stack = dyn_array_make(
+      Array_Tokenizer_Parent, .allocator = context->temp_allocator, .capacity = 32
+    ),
+    .source_file = source_range.file,
+    .result = {.tag = Mass_Result_Tag_Success},
+  };
+
+  Fixed_Buffer *string_buffer = fixed_buffer_make(.capacity = 4096, .allocator = context->temp_allocator);
+
+  tokenizer_tables_init();
+  if (tokenizer_scan_mode == Tokenizer_Scan_Mode_Auto) {
+    tokenizer_scan_mode = tokenizer_scan_mode_detect();
+  }
+  const Tokenizer_Scan_Mode scan_mode = tokenizer_scan_mode;
+
+  u64 end_offset = source_range.offsets.to;
+
+  Array_Tokenizer_Chunk chunks;
+  if (range_length(source_range.offsets) >= tokenizer_parallel_min_byte_size) {
+    chunks = tokenizer_split_into_chunks(
+      context->temp_allocator, scan_mode, input, source_range.offsets, tokenizer_parallel_chunk_byte_size
+    );
+  } else {
+    chunks = dyn_array_make(Array_Tokenizer_Chunk, .allocator = context->temp_allocator, .capacity = 1);
+    dyn_array_push(chunks, (Tokenizer_Chunk) { .offsets = source_range.offsets });
+  }
+
+  Tokenizer_Worker *workers = 0;
+  u64 max_worker_count = tokenizer_parallel_max_worker_count;
+  if (!max_worker_count) max_worker_count = system_logical_processor_count();
+  u64 worker_count = u64_min(dyn_array_length(chunks), max_worker_count);
+  if (worker_count > 1) {
+    Tokenizer_Parallel_Job job = {
+      .input = input,
+      .scan_mode = scan_mode,
+      .chunks = dyn_array_raw(chunks),
+      .chunk_count = dyn_array_length(chunks),
+    };
+    workers = allocator_allocate_array(context->temp_allocator, Tokenizer_Worker, worker_count);
+    tokenizer_scan_chunks_in_parallel(&job, workers, worker_count);
+  } else {
+    worker_count = 0;
+    DYN_ARRAY_FOREACH(Tokenizer_Chunk, chunk, chunks) {
+      u64 capacity = u64_max(16, range_length(chunk->offsets) / 4);
+      tokenizer_scan_chunk(context->temp_allocator, scan_mode, input, chunk, capacity);
+    }
+  }
+
+  Token_Stream *stream = mass_allocate(context, Token_Stream);
+  if (!tokenizer_stream_from_chunks(context, &state, input, chunks, end_offset, stream)) goto defer;
+
+  // Create top-level block
+  tokenizer_group_start_curly(context, &state, source_range.offsets.from);
+
+  tokenizer_build_tokens(context, &state, &string_buffer, stream, 0, stream->count);
+
+  // Scanning finalizes the last token at `end_offset` and then steps once more past it
+  u64 offset = end_offset + 1;
   if (!tokenizer_group_end_curly(context, &state, offset + 1)) panic("UNREACHEABLE");
 
   defer:
@@ -600,7 +1308,9 @@ tokenize(
     Value *root_value = *dyn_array_pop(state.token_stack);
     *out_block = *value_as_ast_block(root_value);
   }
+  for (u64 i = 0; i < worker_count; ++i) {
+    virtual_memory_buffer_deinit(&workers[i].temp_buffer);
+  }
   context_temp_reset_to_mark(context, temp_mark);
   return state.result;
 }
-
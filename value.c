@@ -35,6 +35,61 @@ source_from_source_range(
   return slice_sub_range(source_range->file->text, offsets);
 }
 
+static void
+source_file_ensure_line_starts(
+  Compilation *compilation,
+  const Source_File *const_file
+) {
+  if (const_file->line_starts) return;
+  // The index is derived from the text, so the file is logically unchanged
+  Source_File *file = (Source_File *)const_file;
+  Slice text = file->text;
+  u64 line_count = 1;
+  for (const char *it = text.bytes, *end = text.bytes + text.length; it < end; ++it) {
+    it = memchr(it, '\n', end - it);
+    if (!it) break;
+    line_count += 1;
+  }
+  u32 *line_starts = allocator_allocate_array(compilation->allocator, u32, line_count);
+  line_starts[0] = 0;
+  u64 line_index = 1;
+  for (u64 i = 0; i < text.length; ++i) {
+    if (text.bytes[i] == '\n') line_starts[line_index++] = u64_to_u32(i + 1);
+  }
+  assert(line_index == line_count);
+  file->line_starts = line_starts;
+  file->line_count = line_count;
+}
+
+// Lines are 1-based and columns are 0-based byte offsets from the start of the line.
+// A `\n` is considered to be the last character of the line it ends.
+static Source_Position
+source_range_to_line_column(
+  Compilation *compilation,
+  const Source_Range *source_range
+) {
+  const Source_File *file = source_range->file;
+  if (!file) return (Source_Position){0};
+  source_file_ensure_line_starts(compilation, file);
+
+  // Find the last line that starts at or before the offset
+  u32 offset = source_range->offsets.from;
+  u64 low = 0;
+  u64 high = file->line_count;
+  while (high - low > 1) {
+    u64 middle = low + (high - low) / 2;
+    if (file->line_starts[middle] <= offset) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return (Source_Position) {
+    .line = low + 1,
+    .column = offset - file->line_starts[low],
+  };
+}
+
 static void
 source_range_print_start_position(
   Compilation *compilation,
@@ -44,20 +99,8 @@ source_range_print_start_position(
     printf(":(0:0)\n");
     return;
   }
-  Source_Position from_position = {.line = 0, .column = 0};
-  const Source_File *file = source_range->file;
-  Slice source = file->text;
-  u64 line_start_offset = 0;
-  for (u64 i = 0; i < source.length; ++i) {
-    if (source.bytes[i] != '\n') continue;
-    // if the range starts at the \n it is considered part of the current line, not the next one
-    if (i == source_range->offsets.from) break;
-    from_position.line += 1;
-    if (i > source_range->offsets.from) break;
-    line_start_offset = i + 1;
-  }
-  from_position.column = source_range->offsets.from - line_start_offset;
-  slice_print(file->path);
+  Source_Position from_position = source_range_to_line_column(compilation, source_range);
+  slice_print(source_range->file->path);
   printf(":(%" PRIu64 ":%" PRIu64 ")\n", from_position.line, from_position.column);
 }
 
@@ -468,6 +511,15 @@ same_type(
   return types_equal(a, b, Brand_Comparison_Mode_Strict);
 }
 
+// Any two descriptors that `same_type` considers equal have the same hash
+static inline u64
+same_type_hash(
+  const Descriptor *descriptor
+) {
+  u64 kind = (u64)descriptor->tag | (descriptor->bit_size.as_u64 << 8);
+  return hash_u64(kind ^ (u64)(uintptr_t)descriptor->brand);
+}
+
 static inline u64
 descriptor_byte_size(
   const Descriptor *descriptor
@@ -1042,9 +1094,20 @@ storage_release_if_temporary(
   }
 }
 
+// Returns the address the running code sees, which might not be writable :DualMappedJit
 static inline void *
 rip_value_pointer_from_label(
   const Label *label
+) {
+  assert(label->resolved);
+  const Section *section = label->section;
+  return (s8 *)section->buffer.memory + section->execution_offset + label->offset_in_section;
+}
+
+// Returns the address the compiler should use to write into the section :DualMappedJit
+static inline void *
+rip_value_writable_pointer_from_label(
+  const Label *label
 ) {
   assert(label->resolved);
   return (s8 *)label->section->buffer.memory + label->offset_in_section;
@@ -1062,16 +1125,25 @@ rip_value_pointer_from_storage(
   return base + storage->Memory.location.Instruction_Pointer_Relative.offset;
 }
 
-static inline Descriptor *
+static inline void *
+rip_value_writable_pointer_from_storage(
+  const Storage *storage
+) {
+  assert(storage_is_label(storage));
+  const Label *label = storage->Memory.location.Instruction_Pointer_Relative.label;
+  u8 *base = rip_value_writable_pointer_from_label(label);
+  return base + storage->Memory.location.Instruction_Pointer_Relative.offset;
+}
+
+static inline const Descriptor *
 descriptor_array_of(
-  const Allocator *allocator,
+  Compilation *compilation,
   const Descriptor *item_descriptor,
   u64 length
 ) {
-  Descriptor *result = allocator_allocate(allocator, Descriptor);
   u64 item_bit_alignment = item_descriptor->bit_alignment.as_u64;
   u64 aligned_item_size = u64_align(item_descriptor->bit_size.as_u64, item_bit_alignment);
-  *result = (Descriptor) {
+  Descriptor candidate = {
     .tag = Descriptor_Tag_Fixed_Array,
     .bit_size = {aligned_item_size * length},
     .bit_alignment = {item_bit_alignment},
@@ -1080,6 +1152,13 @@ descriptor_array_of(
       .length = length,
     },
   };
+  const Descriptor *result = descriptor_intern(compilation, &candidate);
+  if (result == &candidate) {
+    // Item types that live in the temp arena can not be interned
+    Descriptor *copy = allocator_allocate(compilation->allocator, Descriptor);
+    *copy = candidate;
+    result = copy;
+  }
   return result;
 }
 
@@ -1169,6 +1248,244 @@ descriptor_pointer_to(
   return result;
 }
 
+static inline bool
+mass_is_temp_address(
+  const Compilation *compilation,
+  const void *address
+) {
+  const Virtual_Memory_Buffer *temp = &compilation->temp_buffer;
+  const s8 *byte_address = address;
+  return byte_address >= temp->memory && byte_address < temp->memory + temp->capacity;
+}
+
+// Hashes only the descriptor itself, referenced descriptors are hashed by address
+// as they are expected to be interned already when it matters
+static u64
+descriptor_intern_hash(
+  const Descriptor *descriptor
+) {
+  u64 hash = hash_u64(
+    (u64)descriptor->tag ^ (descriptor->bit_size.as_u64 << 8) ^ (descriptor->bit_alignment.as_u64 << 40)
+  );
+  hash = hash_u64(hash ^ (u64)(uintptr_t)descriptor->brand);
+  hash = hash_u64(hash ^ (u64)(uintptr_t)descriptor->own_module);
+  switch(descriptor->tag) {
+    case Descriptor_Tag_Void:
+    case Descriptor_Tag_Never:
+    case Descriptor_Tag_Raw:
+    case Descriptor_Tag_Float:
+    case Descriptor_Tag_Function_Instance: break;
+    case Descriptor_Tag_Integer: {
+      hash = hash_u64(hash ^ descriptor->Integer.is_signed);
+    } break;
+    case Descriptor_Tag_Pointer_To: {
+      hash = hash_u64(hash ^ (u64)(uintptr_t)descriptor->Pointer_To.descriptor);
+    } break;
+    case Descriptor_Tag_Fixed_Array: {
+      hash = hash_u64(hash ^ (u64)(uintptr_t)descriptor->Fixed_Array.item);
+      hash = hash_u64(hash ^ descriptor->Fixed_Array.length);
+    } break;
+    case Descriptor_Tag_Struct: {
+      DYN_ARRAY_FOREACH(Struct_Field, field, descriptor->Struct.fields) {
+        hash = hash_u64(hash ^ hash_slice(field->name));
+        hash = hash_u64(hash ^ (u64)(uintptr_t)field->descriptor);
+        hash = hash_u64(hash ^ field->offset);
+      }
+    } break;
+  }
+  return hash;
+}
+
+static bool
+descriptor_intern_equal(
+  const Descriptor *a,
+  const Descriptor *b
+) {
+  if (a->tag != b->tag) return false;
+  if (a->brand != b->brand) return false;
+  if (a->own_module != b->own_module) return false;
+  if (a->bit_size.as_u64 != b->bit_size.as_u64) return false;
+  if (a->bit_alignment.as_u64 != b->bit_alignment.as_u64) return false;
+  switch(a->tag) {
+    case Descriptor_Tag_Void:
+    case Descriptor_Tag_Never:
+    case Descriptor_Tag_Raw:
+    case Descriptor_Tag_Float: return true;
+    case Descriptor_Tag_Function_Instance: return false;
+    case Descriptor_Tag_Integer: return a->Integer.is_signed == b->Integer.is_signed;
+    case Descriptor_Tag_Pointer_To: return a->Pointer_To.descriptor == b->Pointer_To.descriptor;
+    case Descriptor_Tag_Fixed_Array: {
+      return a->Fixed_Array.item == b->Fixed_Array.item && a->Fixed_Array.length == b->Fixed_Array.length;
+    }
+    case Descriptor_Tag_Struct: {
+      u64 field_count = dyn_array_length(a->Struct.fields);
+      if (field_count != dyn_array_length(b->Struct.fields)) return false;
+      for (u64 i = 0; i < field_count; ++i) {
+        const Struct_Field *a_field = dyn_array_get(a->Struct.fields, i);
+        const Struct_Field *b_field = dyn_array_get(b->Struct.fields, i);
+        if (a_field->descriptor != b_field->descriptor) return false;
+        if (a_field->offset != b_field->offset) return false;
+        if (!slice_equal(a_field->name, b_field->name)) return false;
+      }
+      return true;
+    }
+  }
+  panic("Unexpected descriptor tag");
+  return false;
+}
+
+// Interned descriptors outlive the temp arena, so they must not reference anything in it
+static bool
+descriptor_is_internable(
+  const Compilation *compilation,
+  const Descriptor *descriptor
+) {
+  if (mass_is_temp_address(compilation, descriptor->brand)) return false;
+  if (mass_is_temp_address(compilation, descriptor->own_module)) return false;
+  switch(descriptor->tag) {
+    case Descriptor_Tag_Void:
+    case Descriptor_Tag_Never:
+    case Descriptor_Tag_Raw:
+    case Descriptor_Tag_Float:
+    case Descriptor_Tag_Integer: return true;
+    // Signatures are compared structurally, so there is little to gain from interning
+    case Descriptor_Tag_Function_Instance: return false;
+    case Descriptor_Tag_Pointer_To: {
+      return !mass_is_temp_address(compilation, descriptor->Pointer_To.descriptor);
+    }
+    case Descriptor_Tag_Fixed_Array: {
+      return !mass_is_temp_address(compilation, descriptor->Fixed_Array.item);
+    }
+    case Descriptor_Tag_Struct: {
+      DYN_ARRAY_FOREACH(Struct_Field, field, descriptor->Struct.fields) {
+        if (mass_is_temp_address(compilation, field->descriptor)) return false;
+        if (mass_is_temp_address(compilation, field->name.bytes)) return false;
+      }
+      return true;
+    }
+  }
+  panic("Unexpected descriptor tag");
+  return false;
+}
+
+// Returns a canonical permanent copy of the descriptor so that structurally identical
+// descriptors built in different places end up at the same address and `same_type`
+// can return on its pointer equality check without recursing.
+// The provided descriptor is never modified or retained and can be freely reused.
+static const Descriptor *
+descriptor_intern(
+  Compilation *compilation,
+  const Descriptor *descriptor
+) {
+  if (!descriptor_is_internable(compilation, descriptor)) return descriptor;
+  u64 hash = descriptor_intern_hash(descriptor);
+  Descriptor_Intern_Entry **maybe_head = hash_map_get(compilation->descriptor_intern_map, hash);
+  Descriptor_Intern_Entry *head = maybe_head ? *maybe_head : 0;
+  for (Descriptor_Intern_Entry *entry = head; entry; entry = entry->next) {
+    if (entry->descriptor == descriptor || descriptor_intern_equal(entry->descriptor, descriptor)) {
+      compilation->counters.descriptor_intern_hits += 1;
+      return entry->descriptor;
+    }
+  }
+  compilation->counters.descriptor_intern_misses += 1;
+
+  Descriptor *canonical = allocator_allocate(compilation->allocator, Descriptor);
+  *canonical = *descriptor;
+  if (canonical->tag == Descriptor_Tag_Struct) {
+    Array_Struct_Field source_fields = descriptor->Struct.fields;
+    canonical->Struct.fields = dyn_array_make(
+      Array_Struct_Field,
+      .allocator = compilation->allocator,
+      .capacity = dyn_array_length(source_fields),
+    );
+    DYN_ARRAY_FOREACH(Struct_Field, field, source_fields) {
+      dyn_array_push(canonical->Struct.fields, *field);
+    }
+  }
+
+  Descriptor_Intern_Entry *entry = allocator_allocate(compilation->allocator, Descriptor_Intern_Entry);
+  *entry = (Descriptor_Intern_Entry) { .descriptor = canonical, .next = head };
+  hash_map_set(compilation->descriptor_intern_map, hash, entry);
+  return canonical;
+}
+
+// Only hashes the parameters that `function_literal_info_for_parameters` specializes
+static u64
+function_specialization_hash(
+  const Function_Literal *literal,
+  Array_Function_Parameter specialized_parameters
+) {
+  u64 hash = dyn_array_length(specialized_parameters);
+  for (u64 i = 0; i < dyn_array_length(specialized_parameters); ++i) {
+    const Function_Parameter *param = dyn_array_get(specialized_parameters, i);
+    if (!param->descriptor) continue;
+    const Function_Parameter *unspecialized = dyn_array_get(literal->header.parameters, i);
+    if (unspecialized->tag != Function_Parameter_Tag_Generic) continue;
+    hash = hash_u64(hash ^ same_type_hash(param->descriptor));
+    if (param->tag == Function_Parameter_Tag_Exact_Static) {
+      // :StaticGenericToExactStatic
+      // Other static values are compared field by field so they only hash by type
+      switch(param->descriptor->tag) {
+        case Descriptor_Tag_Float:
+        case Descriptor_Tag_Integer:
+        case Descriptor_Tag_Raw:
+        case Descriptor_Tag_Pointer_To: {
+          const void *memory = storage_static_memory_with_bit_size(
+            &param->Exact_Static.storage, param->descriptor->bit_size
+          );
+          hash ^= hash_bytes(memory, descriptor_byte_size(param->descriptor));
+        } break;
+        default: break;
+      }
+    }
+  }
+  return hash;
+}
+
+static bool
+function_specialization_parameters_match(
+  const Function_Literal *literal,
+  Array_Function_Parameter cached_parameters,
+  Array_Function_Parameter current_parameters
+) {
+  if (dyn_array_length(cached_parameters) != dyn_array_length(current_parameters)) return false;
+  for (u64 i = 0; i < dyn_array_length(cached_parameters); ++i) {
+    const Function_Parameter *cached = dyn_array_get(cached_parameters, i);
+    const Function_Parameter *current = dyn_array_get(current_parameters, i);
+    if (cached->tag != current->tag) {
+      panic("Specialized parameter tag should not depend on source parameters");
+    }
+    switch(cached->tag) {
+      case Function_Parameter_Tag_Runtime: {
+        // Can be null but must be the same since we don't modify `Runtime` params above
+        assert(cached->descriptor == current->descriptor);
+      } break;
+      case Function_Parameter_Tag_Generic: {
+        if (!same_type(cached->descriptor, current->descriptor)) return false;
+      } break;
+      case Function_Parameter_Tag_Exact_Static: {
+        const Function_Parameter *unspecialized = dyn_array_get(literal->header.parameters, i);
+        // :StaticGenericToExactStatic
+        // Only need to compare exact static args if they were created above, as hardcoded
+        // `Exact_Static` args aren't supposed to change anyway
+        if (unspecialized->tag == Function_Parameter_Tag_Generic) {
+          assert(unspecialized->Generic.is_static);
+          if (cached->descriptor != current->descriptor) return false;
+          if (!storage_static_equal(
+            cached->descriptor, &cached->Exact_Static.storage,
+            current->descriptor, &current->Exact_Static.storage
+          )) {
+            return false;
+          }
+        } else {
+          assert(cached->descriptor == current->descriptor);
+        }
+      } break;
+    }
+  }
+  return true;
+}
+
 static Function_Info *
 function_literal_info_for_parameters(
   Mass_Context *context,
@@ -1231,44 +1548,18 @@ function_literal_info_for_parameters(
     specialized_param->descriptor = actual_descriptor;
   }
 
-  DYN_ARRAY_FOREACH(Function_Specialization, specialization, literal->specializations) {
-    if (dyn_array_length(specialization->parameters) != dyn_array_length(temp_specialized_parameters)) continue;
-    for (u64 i = 0; i < dyn_array_length(specialization->parameters); ++i) {
-      const Function_Parameter *cached = dyn_array_get(specialization->parameters, i);
-      const Function_Parameter *current = dyn_array_get(temp_specialized_parameters, i);
-      if (cached->tag != current->tag) {
-        panic("Specialized parameter tag should not depend on source parameters");
-      }
-      switch(cached->tag) {
-        case Function_Parameter_Tag_Runtime: {
-          // Can be null but must be the same since we don't modify `Runtime` params above
-          assert(cached->descriptor == current->descriptor);
-        } break;
-        case Function_Parameter_Tag_Generic: {
-          if (!same_type(cached->descriptor, current->descriptor)) goto not_matched;
-        } break;
-        case Function_Parameter_Tag_Exact_Static: {
-          const Function_Parameter *unspecialized = dyn_array_get(literal->header.parameters, i);
-          // :StaticGenericToExactStatic
-          // Only need to compare exact static args if they were created above, as hardcoded
-          // `Exact_Static` args aren't supposed to change anyway
-          if (unspecialized->tag == Function_Parameter_Tag_Generic) {
-            assert(unspecialized->Generic.is_static);
-            if (cached->descriptor != current->descriptor) goto not_matched;
-            if (!storage_static_equal(
-              cached->descriptor, &cached->Exact_Static.storage,
-              current->descriptor, &current->Exact_Static.storage
-            )) {
-              goto not_matched;
-            }
-          } else {
-            assert(cached->descriptor == current->descriptor);
-          }
-        } break;
+  u64 specialization_hash = function_specialization_hash(literal, temp_specialized_parameters);
+  if (literal->specialization_map) {
+    u64 *newest = hash_map_get(literal->specialization_map, specialization_hash);
+    for (u64 index = newest ? *newest : 0; index;) {
+      const Function_Specialization *specialization = dyn_array_get(literal->specializations, index - 1);
+      if (function_specialization_parameters_match(
+        literal, specialization->parameters, temp_specialized_parameters
+      )) {
+        return specialization->info;
       }
+      index = specialization->previous_with_same_hash;
     }
-    return specialization->info;
-    not_matched:;
   }
 
   // The cache didn't match so we need a permanent copy of the parameters
@@ -1296,10 +1587,19 @@ function_literal_info_for_parameters(
     specialized_info->flags |= Function_Info_Flags_Compile_Time;
   }
 
+  if (!literal->specialization_map) {
+    mutable_literal->specialization_map =
+      hash_map_make(Function_Specialization_Map, .allocator = context->allocator, .initial_capacity = 8);
+  }
+  u64 *newest = hash_map_get(literal->specialization_map, specialization_hash);
   dyn_array_push(mutable_literal->specializations, (Function_Specialization) {
     .parameters = specialized_parameters,
     .info = specialized_info,
+    .previous_with_same_hash = newest ? *newest : 0,
   });
+  hash_map_set(
+    literal->specialization_map, specialization_hash, dyn_array_length(literal->specializations)
+  );
 
   if (mass_has_error(context)) return 0;
 
@@ -1340,27 +1640,21 @@ host_os() {
   #endif
 }
 
-static inline const Symbol *
-mass_ensure_symbol_for_map(
-  const Allocator *allocator,
-  Symbol_Map *map,
-  Slice name
+// Bookkeeping is kept next to the public part of the symbol which is only valid
+// for symbols made by `mass_ensure_symbol` or by operator definitions
+static inline Interned_Symbol *
+symbol_interned(
+  const Symbol *symbol
 ) {
-  u64 hash = Symbol_Map__hash(name);
-  const Symbol *symbol = 0;
-  Symbol **cache_entry = hash_map_get_by_hash(map, hash, name);
-  if (cache_entry) {
-    symbol = *cache_entry;
-  }
-  if (!symbol) {
-    Symbol *heap_symbol = allocator_allocate(allocator, Symbol);
-    *heap_symbol = (Symbol){
-      .name = name,
-    };
-    symbol = heap_symbol;
-    hash_map_set_by_hash(map, hash, name, heap_symbol);
-  }
-  return symbol;
+  return (Interned_Symbol *)symbol;
+}
+
+static inline u32
+mass_next_symbol_id(
+  Compilation *compilation
+) {
+  compilation->symbol_count += 1;
+  return u64_to_u32(compilation->symbol_count);
 }
 
 static inline const Symbol *
@@ -1368,7 +1662,17 @@ mass_ensure_symbol(
   Compilation *compilation,
   Slice name
 ) {
-  return mass_ensure_symbol_for_map(compilation->allocator, compilation->symbol_cache_map, name);
+  Symbol_Map *map = compilation->symbol_cache_map;
+  u64 hash = Symbol_Map__hash(name);
+  Symbol **cache_entry = hash_map_get_by_hash(map, hash, name);
+  if (cache_entry) return *cache_entry;
+  Interned_Symbol *interned = allocator_allocate(compilation->allocator, Interned_Symbol);
+  *interned = (Interned_Symbol){
+    .symbol = { .name = name },
+    .id = mass_next_symbol_id(compilation),
+  };
+  hash_map_set_by_hash(map, hash, name, &interned->symbol);
+  return &interned->symbol;
 }
 
 static void
@@ -1380,6 +1684,11 @@ jit_init(
     .import_library_handles = hash_map_make(Jit_Import_Library_Handle_Map),
     .program = program,
   };
+  // :ReclaimableJitThunk
+  virtual_memory_buffer_init(&jit->thunk_buffer, 1llu * 1024 * 1024 * 1024);
+  jit->thunk_buffer.commit_step_byte_size = 1024 * 1024;
+  jit->thunk_allocator = virtual_memory_buffer_allocator_make(&jit->thunk_buffer);
+  jit->thunk_buffer_floor = jit->thunk_buffer.occupied;
 }
 
 static void
@@ -1388,6 +1697,7 @@ jit_deinit(
 ) {
   if (jit->program) program_deinit(jit->program);
   if (jit->import_library_handles) hash_map_destroy(jit->import_library_handles);
+  if (jit->thunk_buffer.memory) virtual_memory_buffer_deinit(&jit->thunk_buffer);
 }
 
 static void
@@ -1403,7 +1713,12 @@ compilation_init(
     .prefix_operator_symbol_map = hash_map_make(Operator_Symbol_Map, .initial_capacity = 128),
     .infix_or_suffix_operator_symbol_map = hash_map_make(Operator_Symbol_Map, .initial_capacity = 128),
     .descriptor_pointer_to_cache_map = hash_map_make(Descriptor_Pointer_To_Cache_Map, .initial_capacity = 256),
+    .descriptor_intern_map = hash_map_make(Descriptor_Intern_Map, .initial_capacity = 256),
+    .struct_field_index_map = hash_map_make(Struct_Field_Index_Map, .initial_capacity = 64),
+    .compile_time_eval_cache_map = hash_map_make(Compile_Time_Eval_Cache_Map, .initial_capacity = 64),
     .intrinsic_proc_cache_map = hash_map_make(Intrinsic_Proc_Cache_Map, .initial_capacity = 128),
+    .overload_match_cache_map = hash_map_make(Overload_Match_Cache_Map, .initial_capacity = 256),
+    .source_file_mappings = dyn_array_make(Array_File_Mapping, .capacity = 16),
     .jit = {0},
   };
 
@@ -1420,7 +1735,10 @@ compilation_init(
   );
   compilation->allocation_buffer.commit_step_byte_size = 16 * 1024 * 1024;
   compilation->allocator = virtual_memory_buffer_allocator_make(&compilation->allocation_buffer);
+  #ifdef _WIN32
+  // Elsewhere the warm up thread has not shown a consistent win so it is opt-in, see mass.c
   virtual_memory_buffer_enable_warmup(&compilation->allocation_buffer);
+  #endif
 
   // Get 1 gigabyte of temp space
   virtual_memory_buffer_init_at_address(
@@ -1430,6 +1748,14 @@ compilation_init(
   compilation->temp_allocator = virtual_memory_buffer_allocator_make(&compilation->temp_buffer);
 
   compilation->result = allocator_allocate(compilation->allocator, Mass_Result);
+  compilation->instantiated_literals = dyn_array_make(
+    Array_Function_Literal_Ptr, .allocator = compilation->allocator, .capacity = 256
+  );
+
+  compilation->scope_lookup_cache = allocator_allocate_array(
+    compilation->allocator, Scope_Lookup_Cache_Entry, SCOPE_LOOKUP_CACHE_SIZE
+  );
+  memset(compilation->scope_lookup_cache, 0, sizeof(Scope_Lookup_Cache_Entry) * SCOPE_LOOKUP_CACHE_SIZE);
 
   compilation->runtime_program = allocator_allocate(compilation->allocator, Program);
 
@@ -1471,6 +1797,75 @@ compilation_init(
   mass_compilation_init_scopes(compilation);
 }
 
+#define COMPILATION_PRINT_TOP_INSTANTIATED_LITERALS 10
+
+static void
+compilation_print_counters(
+  Compilation *compilation
+) {
+  const Compilation_Counters *counters = &compilation->counters;
+  u64 lookups = counters->scope_lookup_cache_hits + counters->scope_lookup_cache_misses;
+  printf(
+    "Scope lookup cache: %"PRIu64" hits, %"PRIu64" misses (%.1f%% hit rate)\n",
+    counters->scope_lookup_cache_hits, counters->scope_lookup_cache_misses,
+    lookups ? 100.0 * (double)counters->scope_lookup_cache_hits / (double)lookups : 0.0
+  );
+  u64 matches = counters->overload_match_cache_hits + counters->overload_match_cache_misses;
+  printf(
+    "Overload match cache: %"PRIu64" hits, %"PRIu64" misses (%.1f%% hit rate)\n",
+    counters->overload_match_cache_hits, counters->overload_match_cache_misses,
+    matches ? 100.0 * (double)counters->overload_match_cache_hits / (double)matches : 0.0
+  );
+  u64 evals = counters->compile_time_eval_cache_hits + counters->compile_time_eval_cache_misses;
+  printf(
+    "Compile-time eval cache: %"PRIu64" hits, %"PRIu64" misses (%.1f%% hit rate)\n",
+    counters->compile_time_eval_cache_hits, counters->compile_time_eval_cache_misses,
+    evals ? 100.0 * (double)counters->compile_time_eval_cache_hits / (double)evals : 0.0
+  );
+  printf(
+    "Compile-time evals: %"PRIu64" interpreted, %"PRIu64" compiled to JIT code\n",
+    counters->compile_time_eval_interpreted_count, counters->compile_time_eval_jit_count
+  );
+  printf(
+    "Compile-time calls: %"PRIu64" with register arguments, %"PRIu64" through an args struct\n",
+    counters->trampoline_direct_call_count, counters->trampoline_struct_call_count
+  );
+  printf(
+    "JIT commits: %"PRIu64" (%"PRIu64" skipped with nothing pending)\n",
+    counters->jit_commit_count, counters->jit_skipped_commit_count
+  );
+  printf(
+    "Reclaimed JIT thunks: %"PRIu64" (%"PRIu64" bytes of code)\n",
+    counters->jit_reclaimed_thunk_count, counters->jit_reclaimed_thunk_byte_count
+  );
+  printf(
+    "Interned descriptors: %"PRIu64" unique, %"PRIu64" reused\n",
+    counters->descriptor_intern_misses, counters->descriptor_intern_hits
+  );
+  printf(
+    "Function instances: %"PRIu64" from %"PRIu64" literals\n",
+    counters->function_instance_count, dyn_array_length(compilation->instantiated_literals)
+  );
+
+  // Simple insertion into a short sorted list is enough to find the worst offenders
+  const Function_Literal *top[COMPILATION_PRINT_TOP_INSTANTIATED_LITERALS] = {0};
+  for (u64 literal_index = 0; literal_index < dyn_array_length(compilation->instantiated_literals); ++literal_index) {
+    const Function_Literal *literal = *dyn_array_get(compilation->instantiated_literals, literal_index);
+    u64 count = dyn_array_length(literal->instances);
+    if (count < 2) continue;
+    for (u64 i = 0; i < countof(top); ++i) {
+      if (top[i] && dyn_array_length(top[i]->instances) >= count) continue;
+      memmove(&top[i + 1], &top[i], (countof(top) - i - 1) * sizeof(top[0]));
+      top[i] = literal;
+      break;
+    }
+  }
+  for (u64 i = 0; i < countof(top) && top[i]; ++i) {
+    printf("  %4"PRIu64" instances of the fn at ", dyn_array_length(top[i]->instances));
+    source_range_print_start_position(compilation, &top[i]->body->source_range);
+  }
+}
+
 static void
 compilation_deinit(
   Compilation *compilation
@@ -1482,7 +1877,16 @@ compilation_deinit(
   hash_map_destroy(compilation->infix_or_suffix_operator_symbol_map);
   hash_map_destroy(compilation->trampoline_map);
   hash_map_destroy(compilation->descriptor_pointer_to_cache_map);
+  hash_map_destroy(compilation->descriptor_intern_map);
+  hash_map_destroy(compilation->struct_field_index_map);
+  hash_map_destroy(compilation->compile_time_eval_cache_map);
   hash_map_destroy(compilation->intrinsic_proc_cache_map);
+  hash_map_destroy(compilation->overload_match_cache_map);
+  // Source_File text points directly into these so they must outlive all of the modules
+  DYN_ARRAY_FOREACH(File_Mapping, mapping, compilation->source_file_mappings) {
+    file_mapping_close(mapping);
+  }
+  dyn_array_destroy(compilation->source_file_mappings);
   program_deinit(compilation->runtime_program);
   jit_deinit(&compilation->jit);
   virtual_memory_buffer_deinit(&compilation->allocation_buffer);
@@ -42,6 +42,9 @@ mass_allocate_bytes(
 #define mass_allocate(_CONTEXT_, _TYPE_) \
   ((_TYPE_ *)mass_allocate_bytes((_CONTEXT_), sizeof(_TYPE_), _Alignof(_TYPE_)))
 
+// Must be a power of 2
+#define SCOPE_LOOKUP_CACHE_SIZE 2048
+
 static inline void *
 mass_allocate_bytes_from_descriptor(
   Mass_Context *context,
@@ -400,13 +403,25 @@ descriptor_byte_size(
   const Descriptor *descriptor
 );
 
-static inline Descriptor *
+static const Descriptor *
+descriptor_intern(
+  Compilation *compilation,
+  const Descriptor *descriptor
+);
+
+static inline const Descriptor *
 descriptor_array_of(
-  const Allocator *allocator,
+  Compilation *compilation,
   const Descriptor *item_descriptor,
   u64 length
 );
 
+static Source_Position
+source_range_to_line_column(
+  Compilation *compilation,
+  const Source_Range *source_range
+);
+
 static void
 source_range_print_start_position(
   Compilation *compilation,
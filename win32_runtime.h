@@ -524,7 +524,7 @@ mass_print_value_with_descriptor_and_memory_internal(
       //       coming from the compiler we just do a bit of duck typing check.
       const Struct_Field *tag_field;
       bool has_tag = struct_find_field_by_name(descriptor, slice_literal("tag"), &tag_field, &(u64){ 0 });
-      Scope_Map *tag_scope_map = 0;
+      const Scope *tag_scope = 0;
       Slice chosen_tag = {0};
       if (
         has_tag &&
@@ -534,17 +534,15 @@ mass_print_value_with_descriptor_and_memory_internal(
         tag_field->descriptor->own_module &&
         tag_field->descriptor->own_module->own_scope->tag == Scope_Tag_Declarative
       ) {
-        tag_scope_map = tag_field->descriptor->own_module->own_scope->Declarative.map;
+        tag_scope = tag_field->descriptor->own_module->own_scope;
         const u8 *field_memory = memory + tag_field->offset;
-        for (u64 i = 0; i < tag_scope_map->capacity; ++i) {
-          Scope_Map__Entry *entry = &tag_scope_map->entries[i];
-          if (entry->occupied) {
-            const void *value_memory = storage_static_memory(&value_as_forced(entry->value->value)->storage);
-            if (memcmp(field_memory, value_memory, 4) == 0) {
-              chosen_tag = entry->value->name;
-              printf(".%"PRIslice"", SLICE_EXPAND_PRINTF(chosen_tag));
-              break;
-            }
+        u64 cursor = 0;
+        for (Scope_Entry *entry; (entry = scope_declarative_next_entry(tag_scope, &cursor));) {
+          const void *value_memory = storage_static_memory(&value_as_forced(entry->value)->storage);
+          if (memcmp(field_memory, value_memory, 4) == 0) {
+            chosen_tag = entry->name;
+            printf(".%"PRIslice"", SLICE_EXPAND_PRINTF(chosen_tag));
+            break;
           }
         }
         if (chosen_tag.length == 0) {
@@ -555,11 +553,11 @@ mass_print_value_with_descriptor_and_memory_internal(
       for (u64 i = 0; i < dyn_array_length(descriptor->Struct.fields); ++i) {
         const Struct_Field *field = dyn_array_get(descriptor->Struct.fields, i);
         // If we are in the tagged union only print selected field
-        if (tag_scope_map && !slice_equal(field->name, chosen_tag)) {
+        if (tag_scope && !slice_equal(field->name, chosen_tag)) {
           // FIXME @Speed this is slow but getting a symbol here for a hash lookup is awkward atm
-          for (u64 i = 0; i < tag_scope_map->capacity; ++i) {
-            Scope_Map__Entry *entry = &tag_scope_map->entries[i];
-            if (entry->occupied && slice_equal(entry->value->name, field->name)) goto skip_field;
+          u64 cursor = 0;
+          for (Scope_Entry *entry; (entry = scope_declarative_next_entry(tag_scope, &cursor));) {
+            if (slice_equal(entry->name, field->name)) goto skip_field;
           }
         }
         printf(".%"PRIslice" = ", SLICE_EXPAND_PRINTF(field->name));